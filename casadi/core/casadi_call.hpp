@@ -94,6 +94,12 @@ namespace casadi {
     /** \brief  Get called function */
     const Function& which_function() const override { return fcn_;}
 
+    /** \brief Check if two nodes are equivalent up to a given depth */
+    bool is_equal(const MXNode* node, casadi_int depth) const override {
+      const Call* n = dynamic_cast<const Call*>(node);
+      return n!=nullptr && n->fcn_.get()==fcn_.get() && sameOpAndDeps(node, depth);
+    }
+
     /** \brief  Get function output */
     casadi_int which_output() const override { return -1;}
 
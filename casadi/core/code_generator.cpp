@@ -29,6 +29,7 @@
 #include "convexify.hpp"
 #include <casadi_runtime_str.h>
 #include <iomanip>
+#include <cstdio>
 
 using namespace std;
 namespace casadi {
@@ -54,6 +55,12 @@ namespace casadi {
     bool prefix_set = false;
     this->prefix = "";
     avoid_stack_ = false;
+    this->simd = false;
+    simd_kernel_ = false;
+    this->chunk_size = 0;
+    this->unroll = 0;
+    this->openmp_schedule = "static";
+    this->openmp_chunk = 0;
     indent_ = 2;
 
     // Read options
@@ -95,6 +102,22 @@ namespace casadi {
         casadi_assert_dev(indent_>=0);
       } else if (e.first=="avoid_stack") {
         avoid_stack_ = e.second;
+      } else if (e.first=="simd") {
+        this->simd = e.second;
+      } else if (e.first=="chunk_size") {
+        this->chunk_size = e.second;
+        casadi_assert(this->chunk_size>=0, "Option 'chunk_size' must be nonnegative");
+      } else if (e.first=="unroll") {
+        this->unroll = e.second;
+        casadi_assert(this->unroll>=0, "Option 'unroll' must be nonnegative");
+      } else if (e.first=="openmp_schedule") {
+        this->openmp_schedule = e.second.to_string();
+        casadi_assert(this->openmp_schedule=="static" || this->openmp_schedule=="dynamic"
+          || this->openmp_schedule=="guided",
+          "Option 'openmp_schedule' must be 'static', 'dynamic' or 'guided'");
+      } else if (e.first=="openmp_chunk") {
+        this->openmp_chunk = e.second;
+        casadi_assert(this->openmp_chunk>=0, "Option 'openmp_chunk' must be nonnegative");
       } else if (e.first=="prefix") {
         this->prefix = e.second.to_string();
         prefix_set = true;
@@ -135,6 +158,9 @@ namespace casadi {
       this->suffix = name.substr(dotpos);
     }
 
+    // Chunks pass intermediate results in the work vector
+    if (this->chunk_size>0) avoid_stack_ = true;
+
     // Symbol prefix
     if (this->with_export) dll_export = "CASADI_SYMBOL_EXPORT ";
     if (this->with_import) dll_import = "CASADI_SYMBOL_IMPORT ";
@@ -302,6 +328,13 @@ namespace casadi {
           << "return " << codegen_name <<  "(arg, res, iw, w, mem);\n"
           << "}\n\n";
 
+    // Batched entry point, vectorized over instances
+    if (this->simd) {
+      casadi_assert(f->has_codegen_simd(),
+        "Option 'simd' is not supported for " + f.class_name() + " '" + f.name() + "'");
+      f->codegen_simd(*this, codegen_name);
+    }
+
     // Generate meta information
     f->codegen_meta(*this);
 
@@ -323,6 +356,9 @@ namespace casadi {
   string CodeGenerator::dump() {
     stringstream s;
     dump(s);
+    // Without separate files, the chunks follow the main code
+    casadi_assert(chunk_saved_.empty(), "Cannot generate code while a chunk is open");
+    for (auto&& c : chunks_) s << c << endl;
     return s.str();
   }
 
@@ -424,6 +460,26 @@ namespace casadi {
     // Finalize file
     file_close(s);
 
+    // Chunks, each in a separate file. The chunks belong to the function bodies
+    // of this generator, so all of them are written on every call
+    casadi_assert(chunk_saved_.empty(), "Cannot generate code while a chunk is open");
+    chunk_files_.clear();
+    for (casadi_int k=chunks_.size(); ; ++k) {
+      // Remove chunk files left behind by an earlier generation with more chunks
+      string stale = prefix + this->name + "_chunk" + str(k) + this->suffix;
+      if (std::remove(stale.c_str())) break;
+    }
+    for (casadi_int k=0; k<chunks_.size(); ++k) {
+      chunk_files_.push_back(prefix + this->name + "_chunk" + str(k) + this->suffix);
+      file_open(s, chunk_files_.back());
+      s << "#if defined(__GNUC__) || defined(__clang__)\n"
+        << "#pragma GCC diagnostic ignored \"-Wunused-function\"\n"
+        << "#endif\n\n";
+      dump_preamble(s);
+      s << chunks_[k] << endl;
+      file_close(s);
+    }
+
     // Generate header
     if (this->with_header) {
       // Create a header file
@@ -548,10 +604,7 @@ namespace casadi {
     return "casadi_ri" + str(size);
   }
 
-  void CodeGenerator::dump(std::ostream& s) {
-    // Consistency check
-    casadi_assert_dev(current_indent_ == 0);
-
+  void CodeGenerator::dump_preamble(std::ostream& s) {
     // Prefix internal symbols to avoid symbol collisions
     s << "/* How to prefix internal symbols */\n"
       << "#ifdef CASADI_CODEGEN_PREFIX\n"
@@ -605,6 +658,14 @@ namespace casadi {
 
     // Codegen auxiliary functions
     s << this->auxiliaries.str();
+  }
+
+  void CodeGenerator::dump(std::ostream& s) {
+    // Consistency check
+    casadi_assert_dev(current_indent_ == 0);
+
+    // Macros, types and auxiliary functions
+    dump_preamble(s);
 
     // Print integer constants
     if (!integer_constants_.empty()) {
@@ -982,6 +1043,12 @@ namespace casadi {
     case AUX_MTIMES:
       this->auxiliaries << sanitize_source(casadi_mtimes_str, inst);
       break;
+    case AUX_MTIMES_DENSE:
+      this->auxiliaries << sanitize_source(casadi_mtimes_dense_str, inst);
+      break;
+    case AUX_MTIMES_SPARSE_DENSE:
+      this->auxiliaries << sanitize_source(casadi_mtimes_sparse_dense_str, inst);
+      break;
     case AUX_PROJECT:
       this->auxiliaries << sanitize_source(casadi_project_str, inst);
       break;
@@ -1028,6 +1095,7 @@ namespace casadi {
       add_auxiliary(AUX_IF_ELSE);
       add_auxiliary(AUX_SCAL);
       add_auxiliary(AUX_DOT);
+      add_auxiliary(AUX_AXPY);
       add_auxiliary(AUX_CLEAR);
       this->auxiliaries << sanitize_source(casadi_qr_str, inst);
       break;
@@ -1059,6 +1127,45 @@ namespace casadi {
 
       this->auxiliaries << sanitize_source(casadi_qp_str, inst);
       break;
+    case AUX_IPM:
+      add_auxiliary(AUX_NORM_INF);
+      add_auxiliary(AUX_FMIN);
+      add_auxiliary(AUX_FMAX);
+      this->auxiliaries << sanitize_source(casadi_ipm_str, inst);
+      break;
+    case AUX_OCPQP:
+      add_auxiliary(AUX_IPM);
+      add_auxiliary(AUX_COPY);
+      add_auxiliary(AUX_CLEAR);
+      add_auxiliary(AUX_SCAL);
+      add_auxiliary(AUX_AXPY);
+      add_auxiliary(AUX_DOT);
+      add_auxiliary(AUX_MV);
+      add_auxiliary(AUX_BILIN);
+      add_auxiliary(AUX_MAX);
+      add_auxiliary(AUX_FMIN);
+      add_auxiliary(AUX_FMAX);
+      add_auxiliary(AUX_INF);
+      add_include("math.h");
+      this->auxiliaries << sanitize_source(casadi_ocpqp_str, inst);
+      break;
+    case AUX_IPQP:
+      add_auxiliary(AUX_IPM);
+      add_auxiliary(AUX_COPY);
+      add_auxiliary(AUX_CLEAR);
+      add_auxiliary(AUX_AXPY);
+      add_auxiliary(AUX_DOT);
+      add_auxiliary(AUX_MV);
+      add_auxiliary(AUX_BILIN);
+      add_auxiliary(AUX_TRANS);
+      add_auxiliary(AUX_LDL);
+      add_auxiliary(AUX_MAX);
+      add_auxiliary(AUX_FMIN);
+      add_auxiliary(AUX_FMAX);
+      add_auxiliary(AUX_INF);
+      add_include("math.h");
+      this->auxiliaries << sanitize_source(casadi_ipqp_str, inst);
+      break;
     case AUX_NLP:
       this->auxiliaries << sanitize_source(casadi_nlp_str, inst);
       break;
@@ -1419,6 +1526,18 @@ namespace casadi {
   string CodeGenerator::trans(const string& x, const Sparsity& sp_x,
                                    const string& y, const Sparsity& sp_y,
                                    const string& iw) {
+    // Unrolled: a fixed permutation of the nonzeros
+    if (this->unroll>0 && sp_x.nnz()<=this->unroll) {
+      std::vector<casadi_int> mapping;
+      sp_x.transpose(mapping);
+      // The caller terminates the last statement
+      stringstream s;
+      for (casadi_int k=0; k<mapping.size(); ++k) {
+        if (k>0) s << ";\n";
+        s << unrolled_nz(y, k) << " = " << unrolled_nz(x, mapping[k]);
+      }
+      return s.str();
+    }
     add_auxiliary(CodeGenerator::AUX_TRANS);
     return "casadi_trans(" + x + "," + sparsity(sp_x) + ", "
             + y + ", " + sparsity(sp_y) + ", " + iw + ")";
@@ -1444,6 +1563,19 @@ namespace casadi {
     // If sparsity match, simple copy
     if (sp_arg==sp_res) return copy(arg, sp_arg.nnz(), res);
 
+    // Unrolled: copy matching nonzeros, zero the others
+    if (this->unroll>0 && sp_res.nnz()<=this->unroll) {
+      std::vector<casadi_int> nz = sp_res.get_row();
+      std::vector<casadi_int> col = sp_res.get_col();
+      sp_arg.get_nz(nz, col);
+      stringstream s;
+      for (casadi_int k=0; k<nz.size(); ++k) {
+        if (k>0) s << "\n";
+        s << unrolled_nz(res, k) << " = " << (nz[k]<0 ? "0" : unrolled_nz(arg, nz[k])) << ";";
+      }
+      return s.str();
+    }
+
     // Create call
     add_auxiliary(AUX_PROJECT);
     stringstream s;
@@ -1531,6 +1663,25 @@ namespace casadi {
 
   string CodeGenerator::mv(const string& x, const Sparsity& sp_x,
                                 const string& y, const string& z, bool tr) {
+    // Unrolled: one multiply-add per nonzero of x, same order as casadi_mv
+    if (this->unroll>0 && sp_x.nnz()<=this->unroll) {
+      const casadi_int* colind = sp_x.colind();
+      const casadi_int* row = sp_x.row();
+      stringstream s;
+      for (casadi_int i=0; i<sp_x.size2(); ++i) {
+        for (casadi_int el=colind[i]; el<colind[i+1]; ++el) {
+          if (el>0) s << "\n";
+          if (tr) {
+            s << unrolled_nz(z, i) << " += " << unrolled_nz(x, el) << "*"
+              << unrolled_nz(y, row[el]) << ";";
+          } else {
+            s << unrolled_nz(z, row[el]) << " += " << unrolled_nz(x, el) << "*"
+              << unrolled_nz(y, i) << ";";
+          }
+        }
+      }
+      return s.str();
+    }
     add_auxiliary(AUX_MV);
     return "casadi_mv(" + x + ", " + sparsity(sp_x) + ", " + y + ", "
            + z + ", " +  (tr ? "1" : "0") + ");";
@@ -1547,11 +1698,64 @@ namespace casadi {
                                     const string& y, const Sparsity& sp_y,
                                     const string& z, const Sparsity& sp_z,
                                     const string& w, bool tr) {
+    // Unrolled: one multiply-add per product term, same order as casadi_mtimes
+    if (!tr && this->unroll>0) {
+      const casadi_int *colind_x = sp_x.colind(), *row_x = sp_x.row();
+      const casadi_int *colind_y = sp_y.colind(), *row_y = sp_y.row();
+      const casadi_int *colind_z = sp_z.colind(), *row_z = sp_z.row();
+      // Nonzero index of each row in the current column of z, -1 if missing
+      std::vector<casadi_int> loc(sp_z.size1(), -1);
+      stringstream s;
+      casadi_int n_ops = 0;
+      for (casadi_int cc=0; cc<sp_y.size2() && n_ops<=this->unroll; ++cc) {
+        for (casadi_int kk=colind_z[cc]; kk<colind_z[cc+1]; ++kk) loc[row_z[kk]] = kk;
+        for (casadi_int kk=colind_y[cc]; kk<colind_y[cc+1]; ++kk) {
+          casadi_int rr = row_y[kk];
+          for (casadi_int kk1=colind_x[rr]; kk1<colind_x[rr+1]; ++kk1) {
+            // Entries outside the pattern of z are dropped
+            casadi_int k = loc[row_x[kk1]];
+            if (k<0) continue;
+            if (n_ops++>0) s << "\n";
+            s << unrolled_nz(z, k) << " += " << unrolled_nz(x, kk1) << "*"
+              << unrolled_nz(y, kk) << ";";
+          }
+        }
+        for (casadi_int kk=colind_z[cc]; kk<colind_z[cc+1]; ++kk) loc[row_z[kk]] = -1;
+      }
+      if (n_ops<=this->unroll) return s.str();
+    }
     add_auxiliary(AUX_MTIMES);
     return "casadi_mtimes(" + x + ", " + sparsity(sp_x) + ", " + y + ", " + sparsity(sp_y) + ", "
       + z + ", " + sparsity(sp_z) + ", " + w + ", " +  (tr ? "1" : "0") + ");";
   }
 
+  string CodeGenerator::omp_schedule() const {
+    string s = " schedule(" + this->openmp_schedule;
+    if (this->openmp_chunk>0) s += ", " + str(this->openmp_chunk);
+    return s + ")";
+  }
+
+  string CodeGenerator::unrolled_nz(const string& x, casadi_int k) {
+    // Plain identifiers can be indexed directly, other expressions are parenthesized
+    bool plain = !x.empty() && !isdigit(x[0]);
+    for (char c : x) plain = plain && (isalnum(c) || c=='_');
+    return (plain ? x : "(" + x + ")") + "[" + str(k) + "]";
+  }
+
+  string CodeGenerator::mtimes(const string& x, casadi_int nrow_x, casadi_int ncol_x,
+                                    const string& y, casadi_int ncol_y, const string& z) {
+    add_auxiliary(AUX_MTIMES_DENSE);
+    return "casadi_mtimes_dense(" + x + ", " + str(nrow_x) + ", " + str(ncol_x) + ", "
+      + y + ", " + str(ncol_y) + ", " + z + ");";
+  }
+
+  string CodeGenerator::mtimes(const string& x, const Sparsity& sp_x,
+                                    const string& y, casadi_int ncol_y, const string& z) {
+    add_auxiliary(AUX_MTIMES_SPARSE_DENSE);
+    return "casadi_mtimes_sparse_dense(" + x + ", " + sparsity(sp_x) + ", "
+      + y + ", " + str(ncol_y) + ", " + z + ");";
+  }
+
   void CodeGenerator::print_formatted(const string& s) {
     // Quick return if empty
     if (s.empty()) return;
@@ -1619,7 +1823,7 @@ namespace casadi {
   }
 
   std::string CodeGenerator::sx_work(casadi_int i) {
-    if (avoid_stack_) {
+    if (avoid_stack_ && !simd_kernel_) {
       return "w[" + str(i) + "]";
     } else {
       std::string name = "a"+str(i);
@@ -1631,6 +1835,38 @@ namespace casadi {
     }
   }
 
+  std::string CodeGenerator::chunk_begin() {
+    casadi_assert(chunk_saved_.empty(), "Chunks cannot be nested");
+    std::string fname = shorthand("chunk" + str(chunks_.size()));
+    std::string sig = "void " + fname
+      + "(const casadi_real** arg, casadi_real** res, casadi_real* w)";
+
+    // Declaration, ahead of the functions calling it
+    this->auxiliaries << sig << ";\n\n";
+
+    // Set aside the code generated so far
+    chunk_saved_ = this->buffer.str();
+    this->buffer.str(string());
+    *this << sig << " {\n";
+    return fname;
+  }
+
+  void CodeGenerator::chunk_end() {
+    *this << "}\n";
+    chunks_.push_back(this->buffer.str());
+    this->buffer.str(string());
+    this->buffer << chunk_saved_;
+    chunk_saved_.clear();
+  }
+
+  std::string CodeGenerator::io_nz(const std::string& buf, casadi_int nz) const {
+    if (simd_kernel_) {
+      return buf + "[" + str(nz) + "*n+k]";
+    } else {
+      return buf + "[" + str(nz) + "]";
+    }
+  }
+
   void CodeGenerator::init_local(const string& name, const string& def) {
     bool inserted = local_default_.insert(make_pair(name, def)).second;
     casadi_assert(inserted, name + " already defined");
@@ -49,9 +49,12 @@ namespace casadi {
 #ifndef SWIG
     /// Generate the code to a stream
     void dump(std::ostream& s);
+
+    /// Generate macros, types and auxiliary functions to a stream
+    void dump_preamble(std::ostream& s);
 #endif // SWIG
 
-    /// Generate a file, return code as string
+    /// Generate a file, return code as string, chunks included
     std::string dump();
 
     /** \brief Generate file(s)
@@ -148,6 +151,27 @@ namespace casadi {
     /** \brief Declare a work vector element */
     std::string sx_work(casadi_int i);
 
+    /** \brief Start a chunk of code to be placed in a separate file
+
+        Code generated until chunk_end() forms the body of a function
+        void fname(const casadi_real** arg, casadi_real** res, casadi_real* w)
+        which is compiled as a separate translation unit. Returns fname.
+    */
+    std::string chunk_begin();
+
+    /** \brief End a chunk of code */
+    void chunk_end();
+
+    /** \brief Source files of the chunks written by the last call to generate */
+    const std::vector<std::string>& chunk_files() const { return chunk_files_;}
+
+    /** \brief Access a nonzero of an input or output buffer
+
+        Inside a SIMD kernel, the buffers hold n instances in a structure of
+        arrays layout, i.e. nonzero nz of instance k is found at nz*n+k.
+    */
+    std::string io_nz(const std::string& buf, casadi_int nz) const;
+
     /** \brief Specify the default value for a local variable */
     void init_local(const std::string& name, const std::string& def);
 
@@ -197,6 +221,20 @@ namespace casadi {
                        const std::string& z, const Sparsity& sp_z,
                        const std::string& w, bool tr);
 
+    /** \brief Schedule clause for an OpenMP work-sharing loop */
+    std::string omp_schedule() const;
+
+    /** \brief Access a nonzero of a buffer in unrolled code */
+    static std::string unrolled_nz(const std::string& x, casadi_int k);
+
+    /** \brief Codegen dense matrix-matrix multiplication: z += x*y */
+    std::string mtimes(const std::string& x, casadi_int nrow_x, casadi_int ncol_x,
+                       const std::string& y, casadi_int ncol_y, const std::string& z);
+
+    /** \brief Codegen sparse-dense matrix-matrix multiplication: z += x*y */
+    std::string mtimes(const std::string& x, const Sparsity& sp_x,
+                       const std::string& y, casadi_int ncol_y, const std::string& z);
+
     /** \brief Codegen bilinear form */
     std::string bilin(const std::string& A, const Sparsity& sp_A,
                       const std::string& x, const std::string& y);
@@ -333,6 +371,8 @@ namespace casadi {
       AUX_MV,
       AUX_MV_DENSE,
       AUX_MTIMES,
+      AUX_MTIMES_DENSE,
+      AUX_MTIMES_SPARSE_DENSE,
       AUX_PROJECT,
       AUX_TRI_PROJECT,
       AUX_DENSIFY,
@@ -351,6 +391,9 @@ namespace casadi {
       AUX_FINITE_DIFF,
       AUX_QR,
       AUX_QP,
+      AUX_IPM,
+      AUX_OCPQP,
+      AUX_IPQP,
       AUX_NLP,
       AUX_SQPMETHOD,
       AUX_LDL,
@@ -540,6 +583,31 @@ namespace casadi {
     // Do we want to be lean on stack usage?
     bool avoid_stack_;
 
+    // Generate batched entry points evaluating many instances at once?
+    bool simd;
+
+    // Currently generating a SIMD kernel?
+    bool simd_kernel_;
+
+    // Maximum number of instructions per chunk in a separate file (0: no splitting)
+    casadi_int chunk_size;
+
+    // Code of the chunks, code set aside while generating a chunk
+    std::vector<std::string> chunks_;
+    std::string chunk_saved_;
+
+    // Files written for the chunks
+    std::vector<std::string> chunk_files_;
+
+    // Maximum number of operations for which sparse kernels are unrolled (0: never)
+    casadi_int unroll;
+
+    // Loop schedule of parallel maps with OpenMP ("static", "dynamic" or "guided")
+    std::string openmp_schedule;
+
+    // Number of iterations claimed at once by a thread (0: OpenMP default)
+    casadi_int openmp_chunk;
+
     std::string infinity, nan, real_min;
 
     /** \brief Codegen scalar
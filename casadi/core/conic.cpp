@@ -542,6 +542,85 @@ namespace casadi {
     return type=="Conic" || (recursive && FunctionInternal::is_a(type, recursive));
   }
 
+  bool Conic::detect_ocp_structure(const Sparsity& A, std::vector<casadi_int>& nx,
+                                   std::vector<casadi_int>& nu,
+                                   std::vector<casadi_int>& ng) {
+    /* General strategy: look for the xk+1 diagonal part in A
+    */
+    nx.clear();
+    nu.clear();
+    ng.clear();
+    casadi_int na = A.size1();
+    if (na==0) return false;
+
+    // Find the right-most column for each row in A -> A_skyline
+    // Find the second-to-right-most column -> A_skyline2
+    // Find the left-most column -> A_bottomline
+    Sparsity AT = A.T();
+    const casadi_int *colind = AT.colind(), *row = AT.row();
+    std::vector<casadi_int> A_skyline(na, -1), A_skyline2(na, -1), A_bottomline(na, -1);
+    for (casadi_int i=0; i<na; ++i) {
+      casadi_int pivot = colind[i+1];
+      if (pivot>colind[i]) {
+        A_bottomline[i] = row[colind[i]];
+        A_skyline[i] = row[pivot-1];
+        if (pivot>colind[i]+1) A_skyline2[i] = row[pivot-2];
+      }
+    }
+
+    /*
+    Loop over the right-most columns of A:
+    they form the diagonal part due to xk+1 in gap constraints.
+    detect when the diagonal pattern is broken -> new stage
+    */
+    casadi_int pivot = 0; // Current right-most element
+    casadi_int start_pivot = pivot; // First right-most element that started the stage
+    casadi_int cg = 0; // Counter for non-gap-closing constraints
+    for (casadi_int i=0; i<na; ++i) { // Loop over all rows
+      bool commit = false; // Set true to jump to the stage
+      if (A_skyline[i]>pivot+1) { // Jump to a diagonal in the future
+        nu.push_back(A_skyline[i]-pivot-1); // Size of jump equals number of states
+        commit = true;
+      } else if (A_skyline[i]==pivot+1) { // Walking the diagonal
+        if (A_skyline2[i]<start_pivot) { // Free of below-diagonal entries?
+          pivot++;
+        } else {
+          nu.push_back(0); // We cannot but conclude that we arrived at a new stage
+          commit = true;
+        }
+      } else { // non-gap-closing constraint detected
+        cg++;
+      }
+
+      if (commit) {
+        nx.push_back(pivot-start_pivot+1);
+        ng.push_back(cg); cg=0;
+        start_pivot = A_skyline[i];
+        pivot = A_skyline[i];
+      }
+    }
+    // No dynamics found
+    if (nu.empty()) {
+      nx.clear();
+      ng.clear();
+      return false;
+    }
+    nx.push_back(pivot-start_pivot+1);
+
+    // Correction for k==0
+    nx[0] = A_skyline[0];
+    nu[0] = 0;
+    ng.erase(ng.begin());
+    casadi_int cN=0;
+    for (casadi_int i=na-1; i>=0; --i) {
+      if (A_bottomline[i]<start_pivot) break;
+      cN++;
+    }
+    ng.push_back(cg-cN);
+    ng.push_back(cN);
+    return true;
+  }
+
   void Conic::sdp_to_socp_init(SDPToSOCPMem& mem) const {
 
     Sparsity qsum = reshape(sum2(Q_), np_, np_);
@@ -175,6 +175,18 @@ namespace casadi {
     /// SDP to SOCP conversion initialization
     void sdp_to_socp_init(SDPToSOCPMem& mem) const;
 
+    /** \brief Detect the stage-wise structure of an optimal control problem
+
+        Variables are assumed to be ordered as [x0 u0 x1 u1 ... xN] and constraints as
+        [gap0 lincon0 gap1 lincon1 ... linconN]. The stages are found from the diagonal
+        pattern of x_{k+1} in the gap constraints, with the controls of the first stage
+        lumped together with the initial state. On success, nx and ng have length N+1
+        and nu has length N. Returns false if no dynamics were found.
+    */
+    static bool detect_ocp_structure(const Sparsity& A, std::vector<casadi_int>& nx,
+                                     std::vector<casadi_int>& nu,
+                                     std::vector<casadi_int>& ng);
+
     void serialize(SerializingStream &s, const SDPToSOCPMem& m) const;
     void deserialize(DeserializingStream &s, SDPToSOCPMem& m);
 
@@ -440,12 +440,55 @@ namespace casadi {
     return rev(get_ptr(arg), get_ptr(res), get_ptr(iw), get_ptr(w), 0);
   }
 
+  Function Function::fold_chain(const std::string& name, const std::vector<Function>& chain,
+                                const Dict& opts) const {
+    if (chain.size()==1) return chain[0];
+    Function base = mapaccum(name + "_acc", chain, 1, opts);
+    std::vector<MX> base_in = base.mx_in();
+    std::vector<MX> out = base(base_in);
+    casadi_int ncol = out[0].size2();
+    out[0] = out[0](Slice(), range(ncol-size2_out(0), ncol)); // NOLINT
+    return Function(name, base_in, out, name_in(), name_out(), opts);
+  }
+
   Function Function::fold(casadi_int N, const Dict& opts) const {
-    Function base = mapaccum(N, opts);
+    Dict options = opts;
+
+    // Memory budget for checkpointed reverse mode, in number of stored states
+    casadi_int checkpoints = 0;
+    auto it = options.find("checkpoints");
+    if (it!=options.end()) {
+      checkpoints = it->second;
+      options.erase(it);
+      casadi_assert(checkpoints>=0, "fold: checkpoints must be nonnegative");
+    }
+    if (checkpoints>0 && N>checkpoints) {
+      casadi_assert(n_in()>0 && n_out()>0, "fold: need an accumulated input and output");
+      // Largest chunk size b such that b states on each of the levels fit the budget
+      casadi_int b = 2;
+      for (casadi_int c=2; c<=std::min(N, checkpoints); ++c) {
+        casadi_int levels = 0;
+        for (casadi_int r=N; r>0; r/=c) levels++;
+        if (c*levels<=checkpoints) b = c;
+      }
+      // Tower of folds over chunks of b calls, passing on only the last state
+      std::vector<Function> chain;
+      Function c = *this;
+      casadi_int n = N;
+      while (n!=0) {
+        casadi_int r = n % b;
+        chain.insert(chain.end(), r, c);
+        n = (n-r)/b;
+        c = fold_chain(c.name() + "_fold" + str(b), std::vector<Function>(b, c), options);
+      }
+      return fold_chain("fold_"+name(), chain, options);
+    }
+
+    Function base = mapaccum(N, options);
     std::vector<MX> base_in = base.mx_in();
     std::vector<MX> out = base(base_in);
     out[0] = out[0](Slice(), range((N-1)*size2_out(0), N*size2_out(0))); // NOLINT
-    return Function("fold_"+name(), base_in, out, name_in(), name_out(), opts);
+    return Function("fold_"+name(), base_in, out, name_in(), name_out(), options);
   }
   Function Function::mapaccum(casadi_int N, const Dict& opts) const {
     return mapaccum("mapaccum_"+name(), N, opts);
@@ -579,6 +622,14 @@ namespace casadi {
   Function Function::map(const string& name, const std::string& parallelization, casadi_int n,
       const vector<casadi_int>& reduce_in, const vector<casadi_int>& reduce_out,
         const Dict& opts) const {
+    // Parallel reduction with thread-local partial sums
+    if (parallelization=="openmp") {
+      casadi_assert_dev(in_range(reduce_in, n_in()) && in_range(reduce_out, n_out()));
+      vector<bool> r_in(n_in(), false), r_out(n_out(), false);
+      for (casadi_int i : reduce_in) r_in[i] = true;
+      for (casadi_int i : reduce_out) r_out[i] = true;
+      return MapSum::create(name, parallelization, *this, n, r_in, r_out, opts);
+    }
     // Wrap in an MXFunction
     Function f = map(n, parallelization);
     // Start with the fully mapped inputs
@@ -1197,8 +1248,8 @@ namespace casadi {
     return deserialize(s);
   }
 
-  Function Function::load(const std::string& filename) {
-    FileDeserializer fs(filename);
+  Function Function::load(const std::string& filename, const Dict& opts) {
+    FileDeserializer fs(filename, opts);
     auto t = fs.pop_type();
     if (t==SerializerBase::SerializationType::SERIALIZED_FUNCTION) {
       return fs.blind_unpack_function();
@@ -1369,6 +1420,15 @@ namespace casadi {
     }
   }
 
+  int Function::operator()(const float** arg, float** res,
+      casadi_int* iw, float* w, int mem) const {
+    try {
+      return (*this)->eval_float(arg, res, iw, w, memory(mem));
+    } catch (exception& e) {
+      THROW_ERROR("operator()", e.what());
+    }
+  }
+
   int Function::operator()(const SXElem** arg, SXElem** res,
       casadi_int* iw, SXElem* w, int mem) const {
     try {
@@ -490,6 +490,12 @@ namespace casadi {
     int operator()(const double** arg, double** res,
         casadi_int* iw, double* w) const;
 
+    /** \brief Evaluate memory-less, numerically in single precision
+        Same syntax as the double version, work vector w holds sz_w() floats
+     */
+    int operator()(const float** arg, float** res,
+        casadi_int* iw, float* w, int mem=0) const;
+
     /** \brief Evaluate memory-less SXElem
         Same syntax as the double version, allowing use in templated code
      */
@@ -554,6 +560,12 @@ namespace casadi {
 
         Set base to -1 to unroll all the way; no gains in memory efficiency here.
 
+        For fold, the option 'checkpoints' (a memory budget, in number of stored
+        states) instead creates a tower of folds, which only pass on the last state.
+        Reverse mode derivatives then store the states at the start of each chunk
+        and recompute the states inside a chunk when needed. The chunk size is the
+        largest one for which chunk size times the number of levels fits the budget.
+
     */
     Function mapaccum(const std::string& name, casadi_int N, const Dict& opts = Dict()) const;
     Function mapaccum(const std::string& name, casadi_int N, casadi_int n_accum,
@@ -568,6 +580,7 @@ namespace casadi {
                       const Dict& opts=Dict()) const;
     Function mapaccum(casadi_int N, const Dict& opts = Dict()) const;
     Function fold(casadi_int N, const Dict& opts = Dict()) const;
+
     ///@}
 
     /** \brief  Create a mapped version of this function
@@ -592,7 +605,7 @@ namespace casadi {
                 s_(N-1) <- f(a_(N-1), p_(N-1))
         \endverbatim
 
-        \param parallelization Type of parallelization used: unroll|serial|openmp
+        \param parallelization Type of parallelization used: unroll|serial|openmp|thread|simd
     */
     Function map(casadi_int n, const std::string& parallelization="serial") const;
     Function map(casadi_int n, const std::string& parallelization,
@@ -738,6 +751,12 @@ namespace casadi {
 
     /** \brief Serialize */
     std::string serialize(const Dict& opts=Dict()) const;
+
+    /** \brief Save to a file
+     *
+     * Options: "debug" (bool), "binary" (bool): raw binary format with aligned
+     * arrays, much faster to load than the default text format
+     */
     void save(const std::string &fname, const Dict& opts=Dict()) const;
 
     std::string export_code(const std::string& lang, const Dict& options=Dict()) const;
@@ -948,8 +967,12 @@ namespace casadi {
     /** \brief Build function from serialization */
     static Function deserialize(const std::string& s);
 
-    /** \brief Build function from serialization */
-    static Function load(const std::string& filename);
+    /** \brief Build function from a file
+     *
+     * Options: "mmap" (bool): map the file into memory instead of reading it
+     * through a file stream
+     */
+    static Function load(const std::string& filename, const Dict& opts=Dict());
 
     /** \brief Build function from serialization */
     static Function deserialize(DeserializingStream& s);
@@ -1011,6 +1034,10 @@ namespace casadi {
     Function mapaccum(const std::string& name, const std::vector<Function>& chain,
                       casadi_int n_accum=1, const Dict& opts = Dict()) const;
 
+    /// Helper function for fold, returning only the last accumulated state
+    Function fold_chain(const std::string& name, const std::vector<Function>& chain,
+                        const Dict& opts) const;
+
 #ifdef WITH_EXTRA_CHECKS
     public:
     // How many times have we passed through
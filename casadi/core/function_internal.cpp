@@ -41,6 +41,9 @@
 #include "conic_impl.hpp"
 #include "integrator_impl.hpp"
 #include "external_impl.hpp"
+#include "importer_internal.hpp"
+#include "thread_pool.hpp"
+#include "sparsity_cache.hpp"
 
 #include <cctype>
 #include <typeinfo>
@@ -59,9 +62,11 @@ namespace casadi {
     verbose_ = false;
     print_time_ = false;
     record_time_ = false;
+    init_mem_storage();
   }
 
-  FunctionInternal::FunctionInternal(const std::string& name) : ProtoFunction(name) {
+  FunctionInternal::FunctionInternal(const std::string& name)
+    : ProtoFunction(name), has_structure_hash_(false) {
     // Make sure valid function name
     if (!Function::check_name(name_)) {
       casadi_error("Function name is not valid. A valid function name is a string "
@@ -77,6 +82,8 @@ namespace casadi {
     always_inline_ = false;
     never_inline_ = false;
     jac_penalty_ = 2;
+    coloring_ = "greedy";
+    coloring_recolor_ = 0;
     max_num_dir_ = GlobalOptions::getMaxNumDir();
     user_data_ = nullptr;
     regularity_check_ = false;
@@ -86,6 +93,7 @@ namespace casadi {
     jit_serialize_ = "source";
     jit_base_name_ = "jit_tmp";
     jit_temp_suffix_ = true;
+    jit_chunk_size_ = 0;
     compiler_plugin_ = "clang";
 
     eval_ = nullptr;
@@ -114,16 +122,19 @@ namespace casadi {
   }
 
   ProtoFunction::~ProtoFunction() {
-    for (void* m : mem_) {
-      if (m!=nullptr) casadi_warning("Memory object has not been properly freed");
+    for (int i=0; i<n_mem_; ++i) {
+      if (mem_slot(i).mem!=nullptr) casadi_warning("Memory object has not been properly freed");
     }
-    mem_.clear();
+    for (auto&& b : mem_blocks_) delete[] b.load();
   }
 
   FunctionInternal::~FunctionInternal() {
-    if (jit_cleanup_ && jit_) {
+    if (jit_cleanup_ && jit_ && compiler_plugin_!="native") {
       std::string jit_name = jit_name_ + ".c";
       if (remove(jit_name.c_str())) casadi_warning("Failed to remove " + jit_name);
+      for (auto&& s : jit_sources_) {
+        if (remove(s.c_str())) casadi_warning("Failed to remove " + s);
+      }
     }
   }
 
@@ -202,6 +213,15 @@ namespace casadi {
         "A high value of 'jac_penalty' makes it less likely for the heurstic "
         "to chose the full Jacobian strategy. "
         "The special value -1 indicates never to use the full Jacobian strategy"}},
+      {"coloring",
+       {OT_STRING,
+        "Graph coloring algorithm for Jacobian and Hessian sparsity exploitation: "
+        "'greedy' (default, sequential unidirectional/star coloring) or "
+        "'jones_plassmann' (parallel distance-2 coloring in the thread pool)"}},
+      {"coloring_recolor",
+       {OT_INT,
+        "Number of iterated greedy recoloring passes to reduce the number of colors "
+        "of a distance-2 coloring [default: 0]"}},
       {"user_data",
        {OT_VOIDPTR,
         "A user-defined field that can be used to identify "
@@ -241,9 +261,15 @@ namespace casadi {
         "This is desired for thread-safety. "
         "This behaviour may defeat caching compiler wrappers. "
         "Default: true"}},
+      {"jit_chunk_size",
+       {OT_INT,
+        "Split the generated code into chunks of at most this many instructions, "
+        "each in a separate file compiled in parallel. Requires the 'shell' compiler. "
+        "Default: 0 (no splitting)"}},
       {"compiler",
        {OT_STRING,
-        "Just-in-time compiler plugin to be used."}},
+        "Just-in-time compiler plugin to be used. "
+        "'native' generates machine code in-process (SXFunction on x86-64 only)."}},
       {"jit_options",
        {OT_DICT,
         "Options to be passed to the jit compiler."}},
@@ -344,6 +370,8 @@ namespace casadi {
   Dict FunctionInternal::generate_options(bool is_temp) const {
     Dict opts = ProtoFunction::generate_options(is_temp);
     opts["jac_penalty"] = jac_penalty_;
+    opts["coloring"] = coloring_;
+    opts["coloring_recolor"] = coloring_recolor_;
     opts["user_data"] = user_data_;
     opts["inputs_check"] = inputs_check_;
     if (!is_temp) opts["jit"] = jit_;
@@ -353,6 +381,7 @@ namespace casadi {
     opts["jit_options"] = jit_options_;
     opts["jit_name"] = jit_base_name_;
     opts["jit_temp_suffix"] = jit_temp_suffix_;
+    opts["jit_chunk_size"] = jit_chunk_size_;
     opts["derivative_of"] = derivative_of_;
     opts["ad_weight"] = ad_weight_;
     opts["ad_weight_sp"] = ad_weight_sp_;
@@ -390,6 +419,13 @@ namespace casadi {
     for (auto&& op : opts) {
       if (op.first=="jac_penalty") {
         jac_penalty_ = op.second;
+      } else if (op.first=="coloring") {
+        coloring_ = op.second.to_string();
+        casadi_assert(coloring_=="greedy" || coloring_=="jones_plassmann",
+          "Unknown coloring algorithm '" + coloring_ + "', "
+          "expected 'greedy' or 'jones_plassmann'");
+      } else if (op.first=="coloring_recolor") {
+        coloring_recolor_ = op.second;
       } else if (op.first=="user_data") {
         user_data_ = op.second.to_void_pointer();
       } else if (op.first=="regularity_check") {
@@ -418,6 +454,8 @@ namespace casadi {
         jit_base_name_ = op.second.to_string();
       } else if (op.first=="jit_temp_suffix") {
         jit_temp_suffix_ = op.second;
+      } else if (op.first=="jit_chunk_size") {
+        jit_chunk_size_ = op.second;
       } else if (op.first=="derivative_of") {
         derivative_of_ = op.second;
       } else if (op.first=="ad_weight") {
@@ -558,7 +596,20 @@ namespace casadi {
   }
 
   void FunctionInternal::finalize() {
-    if (jit_) {
+    if (jit_ && compiler_plugin_=="native") {
+      // Machine code generated in-process, no C compiler involved
+      casadi_assert(has_native_code(),
+        "'native' just-in-time compilation not supported for " + class_name());
+      casadi_assert(jit_serialize_=="source",
+        "'native' just-in-time compilation requires jit_serialize 'source'");
+      if (compiler_.is_null()) {
+        if (verbose_) casadi_message("Generating machine code for '" + name_ + "'.");
+        compiler_ = Importer(name_, "native", jit_options_);
+        static_cast<NativeLibrary*>(compiler_.get())->add(name_, native_code());
+      }
+      eval_ = (eval_t) compiler_.get_function(name_);
+      casadi_assert(eval_!=nullptr, "Cannot load JIT'ed function.");
+    } else if (jit_) {
       jit_name_ = jit_base_name_;
       if (jit_temp_suffix_) {
         jit_name_ = temporary_file(jit_name_, ".c");
@@ -571,10 +622,19 @@ namespace casadi {
           Dict opts;
           // Override the default to avoid random strings in the generated code
           opts["prefix"] = "jit";
+          if (jit_chunk_size_>0) {
+            casadi_assert(compiler_plugin_=="shell",
+              "Option 'jit_chunk_size' requires the 'shell' compiler");
+            opts["chunk_size"] = jit_chunk_size_;
+          }
           CodeGenerator gen(jit_name_, opts);
           gen.add(self());
+          std::string jit_file = gen.generate();
           if (verbose_) casadi_message("Compiling function '" + name_ + "'..");
-          compiler_ = Importer(gen.generate(), compiler_plugin_, jit_options_);
+          Dict jit_options = jit_options_;
+          jit_sources_ = gen.chunk_files();
+          if (!jit_sources_.empty()) jit_options["sources"] = jit_sources_;
+          compiler_ = Importer(jit_file, compiler_plugin_, jit_options);
           if (verbose_) casadi_message("Compiling function '" + name_ + "' done.");
         }
         // Try to load
@@ -754,6 +814,10 @@ namespace casadi {
     return ret;
   }
 
+  std::vector<unsigned char> FunctionInternal::native_code() const {
+    casadi_error("'native_code' not defined for " + class_name());
+  }
+
   void FunctionInternal::print_dimensions(ostream &stream) const {
     stream << " Number of inputs: " << n_in_ << endl;
     for (casadi_int i=0; i<n_in_; ++i) {
@@ -959,99 +1023,138 @@ namespace casadi {
     casadi_int nz_in = nnz_in(iind);
     casadi_int nz_out = nnz_out(oind);
 
-    // Evaluation buffers
-    vector<typename JacSparsityTraits<fwd>::arg_t> arg(sz_arg(), nullptr);
-    vector<bvec_t*> res(sz_res(), nullptr);
-    vector<casadi_int> iw(sz_iw());
-    vector<bvec_t> w(sz_w(), 0);
-
-    // Seeds and sensitivities
-    vector<bvec_t> seed(nz_in, 0);
-    arg[iind] = get_ptr(seed);
-    vector<bvec_t> sens(nz_out, 0);
-    res[oind] = get_ptr(sens);
-    if (!fwd) std::swap(seed, sens);
+    // Number of seed directions
+    casadi_int nz_seed = fwd ? nz_in : nz_out;
 
     // Number of forward sweeps we must make
-    casadi_int nsweep = seed.size() / bvec_size;
-    if (seed.size() % bvec_size) nsweep++;
+    casadi_int nsweep = nz_seed / bvec_size;
+    if (nz_seed % bvec_size) nsweep++;
 
     // Print
     if (verbose_) {
       casadi_message(str(nsweep) + string(fwd ? " forward" : " reverse") + " sweeps "
-                     "needed for " + str(seed.size()) + " directions");
-    }
-
-    // Progress
-    casadi_int progress = -10;
-
-    // Temporary vectors
-    std::vector<casadi_int> jcol, jrow;
-
-    // Loop over the variables, bvec_size variables at a time
-    for (casadi_int s=0; s<nsweep; ++s) {
-
-      // Print progress
-      if (verbose_) {
-        casadi_int progress_new = (s*100)/nsweep;
-        // Print when entering a new decade
-        if (progress_new / 10 > progress / 10) {
-          progress = progress_new;
-          casadi_message(str(progress) + " %");
+                     "needed for " + str(nz_seed) + " directions");
+    }
+
+    // Distribute the sweeps over blocks, each with its own work vectors
+    ThreadPool& pool = ThreadPool::instance();
+    bool parallel = GlobalOptions::parallel_sparsity && nsweep>1 && pool.n_workers()>0;
+    casadi_int nblock = parallel ? std::min(nsweep, 4*(pool.n_workers()+1)) : 1;
+
+    // Temporary vectors, per block
+    std::vector<std::vector<casadi_int> > jcol(nblock), jrow(nblock);
+
+    // Perform the sweeps s0, ..., s1-1
+    auto sweep_block = [&](casadi_int b) {
+      casadi_int s0 = (b*nsweep)/nblock, s1 = ((b+1)*nsweep)/nblock;
+
+      // Evaluation buffers
+      vector<typename JacSparsityTraits<fwd>::arg_t> arg(sz_arg(), nullptr);
+      vector<bvec_t*> res(sz_res(), nullptr);
+      vector<casadi_int> iw(sz_iw());
+      vector<bvec_t> w(sz_w(), 0);
+
+      // Seeds and sensitivities
+      vector<bvec_t> seed(nz_in, 0);
+      arg[iind] = get_ptr(seed);
+      vector<bvec_t> sens(nz_out, 0);
+      res[oind] = get_ptr(sens);
+      if (!fwd) std::swap(seed, sens);
+
+      // Memory object, one per block when running in parallel
+      int mem = parallel ? checkout() : 0;
+
+      // Progress
+      casadi_int progress = -10;
+
+      // Loop over the variables, bvec_size variables at a time
+      for (casadi_int s=s0; s<s1; ++s) {
+
+        // Print progress
+        if (verbose_ && !parallel) {
+          casadi_int progress_new = (s*100)/nsweep;
+          // Print when entering a new decade
+          if (progress_new / 10 > progress / 10) {
+            progress = progress_new;
+            casadi_message(str(progress) + " %");
+          }
         }
-      }
 
-      // Nonzero offset
-      casadi_int offset = s*bvec_size;
+        // Nonzero offset
+        casadi_int offset = s*bvec_size;
 
-      // Number of local seed directions
-      casadi_int ndir_local = seed.size()-offset;
-      ndir_local = std::min(static_cast<casadi_int>(bvec_size), ndir_local);
+        // Number of local seed directions
+        casadi_int ndir_local = seed.size()-offset;
+        ndir_local = std::min(static_cast<casadi_int>(bvec_size), ndir_local);
 
-      for (casadi_int i=0; i<ndir_local; ++i) {
-        seed[offset+i] |= bvec_t(1)<<i;
-      }
+        for (casadi_int i=0; i<ndir_local; ++i) {
+          seed[offset+i] |= bvec_t(1)<<i;
+        }
 
-      // Propagate the dependencies
-      JacSparsityTraits<fwd>::sp(this, get_ptr(arg), get_ptr(res),
-                                  get_ptr(iw), get_ptr(w), memory(0));
+        // Propagate the dependencies
+        JacSparsityTraits<fwd>::sp(this, get_ptr(arg), get_ptr(res),
+                                    get_ptr(iw), get_ptr(w), memory(mem));
 
-      // Loop over the nonzeros of the output
-      for (casadi_int el=0; el<sens.size(); ++el) {
+        // Loop over the nonzeros of the output
+        for (casadi_int el=0; el<sens.size(); ++el) {
 
-        // Get the sparsity sensitivity
-        bvec_t spsens = sens[el];
+          // Get the sparsity sensitivity
+          bvec_t spsens = sens[el];
 
-        if (!fwd) {
-          // Clear the sensitivities for the next sweep
-          sens[el] = 0;
-        }
+          if (!fwd) {
+            // Clear the sensitivities for the next sweep
+            sens[el] = 0;
+          }
 
-        // If there is a dependency in any of the directions
-        if (spsens!=0) {
+          // If there is a dependency in any of the directions
+          if (spsens!=0) {
 
-          // Loop over seed directions
-          for (casadi_int i=0; i<ndir_local; ++i) {
+            // Loop over seed directions
+            for (casadi_int i=0; i<ndir_local; ++i) {
 
-            // If dependents on the variable
-            if ((bvec_t(1) << i) & spsens) {
-              // Add to pattern
-              jcol.push_back(el);
-              jrow.push_back(i+offset);
+              // If dependents on the variable
+              if ((bvec_t(1) << i) & spsens) {
+                // Add to pattern
+                jcol[b].push_back(el);
+                jrow[b].push_back(i+offset);
+              }
             }
           }
         }
-      }
 
-      // Remove the seeds
-      for (casadi_int i=0; i<ndir_local; ++i) {
-        seed[offset+i] = 0;
+        // Remove the seeds
+        for (casadi_int i=0; i<ndir_local; ++i) {
+          seed[offset+i] = 0;
+        }
       }
+      if (parallel) release(mem);
+    };
+    if (parallel) {
+      // Exceptions must not escape the worker threads
+      std::vector<std::string> err(nblock);
+      pool.parallel_for(nblock, [&](casadi_int b) {
+        try {
+          sweep_block(b);
+        } catch(std::exception& e) {
+          err[b] = e.what();
+        }
+      });
+      for (auto&& e : err) {
+        if (!e.empty()) casadi_error(e);
+      }
+    } else {
+      sweep_block(0);
+    }
+
+    // Collect the blocks
+    for (casadi_int b=1; b<nblock; ++b) {
+      jcol[0].insert(jcol[0].end(), jcol[b].begin(), jcol[b].end());
+      jrow[0].insert(jrow[0].end(), jrow[b].begin(), jrow[b].end());
     }
 
     // Construct sparsity pattern and return
-    if (!fwd) swap(jrow, jcol);
-    Sparsity ret = Sparsity::triplet(nz_out, nz_in, jcol, jrow);
+    if (!fwd) swap(jrow[0], jcol[0]);
+    Sparsity ret = Sparsity::triplet(nz_out, nz_in, jcol[0], jrow[0]);
     if (verbose_) {
       casadi_message("Formed Jacobian sparsity pattern (dimension " + str(ret.size()) + ", "
           + str(ret.nnz()) + " (" + str(ret.density()) + " %) nonzeros.");
@@ -1667,6 +1770,24 @@ namespace casadi {
   }
 
 
+  const std::string& FunctionInternal::structure_hash() const {
+    if (!has_structure_hash_) {
+      has_structure_hash_ = true;
+      try {
+        // Two independent 64-bit hashes and the length of the serialized function
+        std::string s = self().serialize();
+        std::stringstream ss;
+        ss << std::hex << SparsityCache::hash(s, 14695981039346656037ULL) << ";"
+           << SparsityCache::hash(s, 0x6a09e667f3bcc909ULL) << ";" << std::dec << s.size();
+        structure_hash_ = ss.str();
+      } catch (std::exception&) {
+        // Not serializable, do not cache
+        if (verbose_) casadi_message(name_ + ": Jacobian sparsity not cached");
+      }
+    }
+    return structure_hash_;
+  }
+
   Sparsity& FunctionInternal::
   sparsity_jac(casadi_int iind, casadi_int oind, bool compact, bool symmetric) const {
     // Get an owning reference to the block
@@ -1677,8 +1798,19 @@ namespace casadi {
     if (jsp.is_null()) {
       if (compact) {
 
-        // Use internal routine to determine sparsity
-        jsp = getJacSparsity(iind, oind, symmetric);
+        // Key in the on-disk cache: the hashed function and the block
+        std::string key;
+        if (SparsityCache::enabled() && nnz_in(iind)+nnz_out(oind)>=SparsityCache::min_size
+            && !structure_hash().empty()) {
+          key = "jac_sparsity;" + str(iind) + ";" + str(oind) + ";" + str(symmetric) + ";"
+            + structure_hash();
+        }
+
+        if (key.empty() || !SparsityCache::load(key, jsp)) {
+          // Use internal routine to determine sparsity
+          jsp = getJacSparsity(iind, oind, symmetric);
+          if (!key.empty() && !jsp.is_null()) SparsityCache::store(key, jsp);
+        }
 
       } else {
 
@@ -1724,6 +1856,18 @@ namespace casadi {
     return jsp_ref;
   }
 
+  Sparsity FunctionInternal::uni_coloring(const Sparsity& A, const Sparsity& AT,
+                                          casadi_int cutoff) const {
+    Sparsity D;
+    if (coloring_=="jones_plassmann") {
+      D = A.jp_coloring(AT, cutoff);
+    } else {
+      D = A.uni_coloring(AT, cutoff);
+    }
+    if (!D.is_null() && coloring_recolor_>0) D = A.recolor(D, coloring_recolor_, AT);
+    return D;
+  }
+
   void FunctionInternal::get_partition(casadi_int iind, casadi_int oind, Sparsity& D1, Sparsity& D2,
                                        bool compact, bool symmetric,
                                        bool allow_forward, bool allow_reverse) const {
@@ -1740,8 +1884,15 @@ namespace casadi {
       casadi_assert_dev(allow_forward);
 
       // Star coloring if symmetric
-      if (verbose_) casadi_message("FunctionInternal::getPartition star_coloring");
-      D1 = A.star_coloring();
+      if (coloring_=="jones_plassmann") {
+        // A distance-2 coloring is also a star coloring
+        if (verbose_) casadi_message("FunctionInternal::getPartition jp_coloring");
+        D1 = A.jp_coloring(A);
+        if (coloring_recolor_>0) D1 = A.recolor(D1, coloring_recolor_, A);
+      } else {
+        if (verbose_) casadi_message("FunctionInternal::getPartition star_coloring");
+        D1 = A.star_coloring();
+      }
       if (verbose_) {
         casadi_message("Star coloring completed: " + str(D1.size2())
           + " directional derivatives needed ("
@@ -1781,7 +1932,7 @@ namespace casadi {
           bool d = best_coloring>=w*static_cast<double>(A.size1());
           casadi_int max_colorings_to_test =
             d ? A.size1() : static_cast<casadi_int>(floor(best_coloring/w));
-          D1 = AT.uni_coloring(A, max_colorings_to_test);
+          D1 = uni_coloring(AT, A, max_colorings_to_test);
           if (D1.is_null()) {
             if (verbose_) {
               casadi_message("Forward mode coloring interrupted (more than "
@@ -1802,7 +1953,7 @@ namespace casadi {
           casadi_int max_colorings_to_test =
             d ? A.size2() : static_cast<casadi_int>(floor(best_coloring/(1-w)));
 
-          D2 = A.uni_coloring(AT, max_colorings_to_test);
+          D2 = uni_coloring(A, AT, max_colorings_to_test);
           if (D2.is_null()) {
             if (verbose_) {
               casadi_message("Adjoint mode coloring interrupted (more than "
@@ -1832,6 +1983,32 @@ namespace casadi {
     casadi_error("'eval_sx' not defined for " + class_name());
   }
 
+  int FunctionInternal::
+  eval_float(const float** arg, float** res, casadi_int* iw, float* w, void* mem) const {
+    // Evaluate in double precision
+    std::vector<double> arg_d(nnz_in()), res_d(nnz_out()), w_d(sz_w());
+    std::vector<const double*> argp(sz_arg(), nullptr);
+    std::vector<double*> resp(sz_res(), nullptr);
+    double* p = get_ptr(arg_d);
+    for (casadi_int i=0; i<n_in_; ++i) {
+      if (arg[i]) {
+        std::copy(arg[i], arg[i]+nnz_in(i), p);
+        argp[i] = p;
+      }
+      p += nnz_in(i);
+    }
+    p = get_ptr(res_d);
+    for (casadi_int i=0; i<n_out_; ++i) {
+      if (res[i]) resp[i] = p;
+      p += nnz_out(i);
+    }
+    if (eval_gen(get_ptr(argp), get_ptr(resp), iw, get_ptr(w_d), mem)) return 1;
+    for (casadi_int i=0; i<n_out_; ++i) {
+      if (res[i]) std::copy(resp[i], resp[i]+nnz_out(i), res[i]);
+    }
+    return 0;
+  }
+
   Function FunctionInternal::forward(casadi_int nfwd) const {
     casadi_assert_dev(nfwd>=0);
     // Used wrapped function if forward not available
@@ -2140,6 +2317,10 @@ namespace casadi {
     g.flush(g.body);
   }
 
+  void FunctionInternal::codegen_simd(CodeGenerator& g, const std::string& fname) const {
+    casadi_error("'codegen_simd' not defined for " + class_name());
+  }
+
   std::string FunctionInternal::signature(const std::string& fname) const {
     return "int " + fname + "(const casadi_real** arg, casadi_real** res, "
                             "casadi_int* iw, casadi_real* w, int mem)";
@@ -2585,6 +2766,15 @@ namespace casadi {
     return stats;
   }
 
+  Dict FunctionInternal::get_stats(void* mem) const {
+    Dict stats = ProtoFunction::get_stats(mem);
+    // Statistics of the jit compiler, e.g. cache hits
+    if (jit_ && !compiler_.is_null()) {
+      for (auto&& e : compiler_.get_stats()) stats["jit_" + e.first] = e.second;
+    }
+    return stats;
+  }
+
   bool FunctionInternal::has_derivative() const {
     return enable_forward_ || enable_reverse_ || enable_jacobian_ || enable_fd_;
   }
@@ -3143,10 +3333,54 @@ namespace casadi {
   }
 
   void ProtoFunction::clear_mem() {
-    for (auto&& i : mem_) {
-      if (i!=nullptr) free_mem(i);
-    }
-    mem_.clear();
+    for (int i=0; i<n_mem_; ++i) {
+      MemSlot& m = mem_slot(i);
+      if (m.mem!=nullptr) free_mem(m.mem);
+      m.mem = nullptr;
+    }
+    n_mem_ = 0;
+    unused_ = 0;
+    for (auto&& h : hot_) h.mem = 0;
+  }
+
+  void ProtoFunction::init_mem_storage() {
+    for (auto&& b : mem_blocks_) b = nullptr;
+    n_mem_ = 0;
+    unused_ = 0;
+    for (auto&& h : hot_) h.mem = 0;
+  }
+
+  ProtoFunction::MemSlot& ProtoFunction::mem_slot(int ind) const {
+    // Block b holds the memory objects 2^b-1, ..., 2^(b+1)-2
+    unsigned int k = static_cast<unsigned int>(ind) + 1;
+    int b = 0;
+    while (k >> (b+1)) b++;
+    return mem_blocks_[b].load(std::memory_order_acquire)[k - (1u << b)];
+  }
+
+  void ProtoFunction::push_unused(int ind) const {
+    MemSlot& m = mem_slot(ind);
+    unsigned long long head = unused_.load(std::memory_order_relaxed), new_head;
+    do {
+      // Link to the current head, the tag in the high bits is increased to avoid ABA
+      m.next.store(static_cast<int>(head & 0xffffffffULL) - 1, std::memory_order_relaxed);
+      new_head = ((head >> 32) + 1) << 32 | static_cast<unsigned long long>(ind + 1);
+    } while (!unused_.compare_exchange_weak(head, new_head, std::memory_order_release,
+                                            std::memory_order_relaxed));
+  }
+
+  int ProtoFunction::pop_unused() const {
+    unsigned long long head = unused_.load(std::memory_order_acquire), new_head;
+    int ind;
+    do {
+      ind = static_cast<int>(head & 0xffffffffULL) - 1;
+      if (ind<0) return -1;
+      // Slots are never deallocated, so reading a stale link is harmless
+      int next = mem_slot(ind).next.load(std::memory_order_relaxed);
+      new_head = ((head >> 32) + 1) << 32 | static_cast<unsigned long long>(next + 1);
+    } while (!unused_.compare_exchange_weak(head, new_head, std::memory_order_acquire,
+                                            std::memory_order_acquire));
+    return ind;
   }
 
   size_t FunctionInternal::get_n_in() {
@@ -3222,37 +3456,70 @@ namespace casadi {
   }
 
   void* ProtoFunction::memory(int ind) const {
+    casadi_assert(ind>=0 && ind<n_mem_, "Memory object " + str(ind) + " does not exist");
+    return mem_slot(ind).mem;
+  }
+
+  // Hash of the calling thread, selecting a slot for recently released memory objects
+  static int thread_hash() {
 #ifdef CASADI_WITH_THREAD
-    std::lock_guard<std::mutex> lock(mtx_);
-#endif //CASADI_WITH_THREAD
-    return mem_.at(ind);
+    static std::atomic<int> counter(0);
+    static thread_local int h = counter++;
+    return h;
+#else // CASADI_WITH_THREAD
+    return 0;
+#endif // CASADI_WITH_THREAD
   }
 
   int ProtoFunction::checkout() const {
+    // Fast path: memory object last released by this thread
+    HotSlot& hot = hot_[thread_hash() % n_hot];
+    int m = hot.mem.exchange(0, std::memory_order_acquire);
+    if (m) return m-1;
+
+    // Lock-free list of unused memory objects
+    m = pop_unused();
+    if (m>=0) return m;
+
+    // Memory objects parked by other threads
+    for (auto&& h : hot_) {
+      m = h.mem.exchange(0, std::memory_order_acquire);
+      if (m) return m-1;
+    }
+
+    // Allocate a new memory object
 #ifdef CASADI_WITH_THREAD
     std::lock_guard<std::mutex> lock(mtx_);
 #endif //CASADI_WITH_THREAD
-    if (unused_.empty()) {
-      // Allocate a new memory object
-      void* m = alloc_mem();
-      mem_.push_back(m);
-      if (init_mem(m)) {
-        casadi_error("Failed to create or initialize memory object");
-      }
-      return mem_.size()-1;
-    } else {
-      // Use an unused memory object
-      casadi_int m = unused_.top();
-      unused_.pop();
-      return m;
+    int ind = n_mem_.load(std::memory_order_relaxed);
+    unsigned int k = static_cast<unsigned int>(ind) + 1;
+    int b = 0;
+    while (k >> (b+1)) b++;
+    if (mem_blocks_[b].load(std::memory_order_relaxed)==nullptr) {
+      MemSlot* block = new MemSlot[1u << b];
+      for (unsigned int i=0; i<(1u << b); ++i) {
+        block[i].mem = nullptr;
+        block[i].next.store(-1, std::memory_order_relaxed);
+      }
+      mem_blocks_[b].store(block, std::memory_order_release);
+    }
+    void* mem = alloc_mem();
+    mem_slot(ind).mem = mem;
+    n_mem_.store(ind+1, std::memory_order_release);
+    if (init_mem(mem)) {
+      casadi_error("Failed to create or initialize memory object");
     }
+    return ind;
   }
 
   void ProtoFunction::release(int mem) const {
-#ifdef CASADI_WITH_THREAD
-    std::lock_guard<std::mutex> lock(mtx_);
-#endif //CASADI_WITH_THREAD
-    unused_.push(mem);
+    // Park in the slot of the calling thread, if empty
+    HotSlot& hot = hot_[thread_hash() % n_hot];
+    int expected = 0;
+    if (hot.mem.compare_exchange_strong(expected, mem+1, std::memory_order_release,
+                                        std::memory_order_relaxed)) return;
+    // Otherwise add to the list of unused memory objects
+    push_unused(mem);
   }
 
   Function FunctionInternal::
@@ -3533,6 +3800,7 @@ namespace casadi {
 
     s.unpack("ProtoFunction::print_time", print_time_);
     s.unpack("ProtoFunction::record_time", record_time_);
+    init_mem_storage();
   }
 
   void FunctionInternal::serialize_type(SerializingStream &s) const {
@@ -3541,7 +3809,7 @@ namespace casadi {
 
   void FunctionInternal::serialize_body(SerializingStream& s) const {
     ProtoFunction::serialize_body(s);
-    s.version("FunctionInternal", 2);
+    s.version("FunctionInternal", 4);
     s.pack("FunctionInternal::is_diff_in", is_diff_in_);
     s.pack("FunctionInternal::is_diff_out", is_diff_out_);
     s.pack("FunctionInternal::sp_in", sparsity_in_);
@@ -3561,6 +3829,7 @@ namespace casadi {
       }
     }
     s.pack("FunctionInternal::jit_temp_suffix", jit_temp_suffix_);
+    s.pack("FunctionInternal::jit_chunk_size", jit_chunk_size_);
     s.pack("FunctionInternal::jit_base_name", jit_base_name_);
     s.pack("FunctionInternal::jit_options", jit_options_);
     s.pack("FunctionInternal::compiler_plugin", compiler_plugin_);
@@ -3569,6 +3838,8 @@ namespace casadi {
     s.pack("FunctionInternal::derivative_of", derivative_of_);
 
     s.pack("FunctionInternal::jac_penalty", jac_penalty_);
+    s.pack("FunctionInternal::coloring", coloring_);
+    s.pack("FunctionInternal::coloring_recolor", coloring_recolor_);
 
     s.pack("FunctionInternal::enable_forward", enable_forward_);
     s.pack("FunctionInternal::enable_reverse", enable_reverse_);
@@ -3613,8 +3884,9 @@ namespace casadi {
     s.pack("FunctionInternal::sz_w_tmp", sz_w_tmp_);
   }
 
-  FunctionInternal::FunctionInternal(DeserializingStream& s) : ProtoFunction(s) {
-    int version = s.version("FunctionInternal", 1, 2);
+  FunctionInternal::FunctionInternal(DeserializingStream& s)
+    : ProtoFunction(s), has_structure_hash_(false) {
+    int version = s.version("FunctionInternal", 1, 4);
     s.unpack("FunctionInternal::is_diff_in", is_diff_in_);
     s.unpack("FunctionInternal::is_diff_out", is_diff_out_);
     s.unpack("FunctionInternal::sp_in", sparsity_in_);
@@ -3647,6 +3919,11 @@ namespace casadi {
       compiler_ = Importer(library, "dll");
     }
     s.unpack("FunctionInternal::jit_temp_suffix", jit_temp_suffix_);
+    if (version>=4) {
+      s.unpack("FunctionInternal::jit_chunk_size", jit_chunk_size_);
+    } else {
+      jit_chunk_size_ = 0;
+    }
     s.unpack("FunctionInternal::jit_base_name", jit_base_name_);
     s.unpack("FunctionInternal::jit_options", jit_options_);
     s.unpack("FunctionInternal::compiler_plugin", compiler_plugin_);
@@ -3655,6 +3932,13 @@ namespace casadi {
     s.unpack("FunctionInternal::derivative_of", derivative_of_);
 
     s.unpack("FunctionInternal::jac_penalty", jac_penalty_);
+    if (version>=3) {
+      s.unpack("FunctionInternal::coloring", coloring_);
+      s.unpack("FunctionInternal::coloring_recolor", coloring_recolor_);
+    } else {
+      coloring_ = "greedy";
+      coloring_recolor_ = 0;
+    }
 
     s.unpack("FunctionInternal::enable_forward", enable_forward_);
     s.unpack("FunctionInternal::enable_reverse", enable_reverse_);
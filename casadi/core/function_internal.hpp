@@ -29,6 +29,7 @@
 #include "function.hpp"
 #include <set>
 #include <stack>
+#include <atomic>
 #include "code_generator.hpp"
 #include "importer.hpp"
 #include "sparse_storage.hpp"
@@ -190,11 +191,44 @@ namespace casadi {
 #endif // CASADI_WITH_THREAD
 
   private:
-    /// Memory objects
-    mutable std::vector<void*> mem_;
+    /// Memory object and link in the list of unused memory objects
+    struct MemSlot {
+      void* mem;
+      std::atomic<int> next;
+    };
+
+    /// Number of per-thread slots for recently released memory objects
+    static const int n_hot = 8;
+
+    /// Slot for a recently released memory object (index+1, 0 if empty), own cache line
+    struct HotSlot {
+      std::atomic<int> mem;
+      char pad[64-sizeof(std::atomic<int>)];
+    };
+
+    /// Access a memory object slot, valid for ind < n_mem_
+    MemSlot& mem_slot(int ind) const;
+
+    /// Push a memory object to the list of unused memory objects
+    void push_unused(int ind) const;
 
-    /// Unused memory objects
-    mutable std::stack<casadi_int> unused_;
+    /// Pop a memory object from the list of unused memory objects, -1 if empty
+    int pop_unused() const;
+
+    /// Memory objects, in blocks of size 1, 2, 4, ... so that they never move
+    mutable std::atomic<MemSlot*> mem_blocks_[32];
+
+    /// Number of memory objects
+    mutable std::atomic<int> n_mem_;
+
+    /// Lock-free list of unused memory objects: ABA tag (high bits), index+1 (low bits)
+    mutable std::atomic<unsigned long long> unused_;
+
+    /// Memory objects released by (a hash of) the calling thread
+    mutable HotSlot hot_[n_hot];
+
+    /// Initialize memory object storage (called from constructors)
+    void init_mem_storage();
   };
 
   /** \brief Internal class for Function
@@ -228,6 +262,9 @@ namespace casadi {
     /** \brief Finalize the object creation */
     void finalize() override;
 
+    /** \brief Get all statistics */
+    Dict get_stats(void* mem) const override;
+
     /** \brief Get a public class instance */
     Function self() const { return shared_from_this<Function>();}
 
@@ -269,6 +306,12 @@ namespace casadi {
     virtual int eval(const double** arg, double** res, casadi_int* iw, double* w, void* mem) const;
     ///@}
 
+    /** \brief  Evaluate numerically in single precision
+        Work vector w holds sz_w() floats. Defaults to double precision with conversions.
+    */
+    virtual int eval_float(const float** arg, float** res, casadi_int* iw, float* w,
+      void* mem) const;
+
     /** \brief  Evaluate with symbolic scalars */
     virtual int eval_sx(const SXElem** arg, SXElem** res,
       casadi_int* iw, SXElem* w, void* mem) const;
@@ -616,6 +659,12 @@ namespace casadi {
     /** \brief Generate code for the function body */
     virtual void codegen_body(CodeGenerator& g) const;
 
+    /** \brief Is a batched (SIMD) entry point available? */
+    virtual bool has_codegen_simd() const { return false;}
+
+    /** \brief Generate a batched entry point, evaluating n instances at once */
+    virtual void codegen_simd(CodeGenerator& g, const std::string& fname) const;
+
     /** \brief Thread-local memory object type */
     virtual std::string codegen_mem_type() const { return ""; }
 
@@ -628,6 +677,12 @@ namespace casadi {
     /** \brief Jit dependencies */
     virtual void jit_dependencies(const std::string& fname) {}
 
+    /** \brief Is in-process machine code generation supported? */
+    virtual bool has_native_code() const { return false;}
+
+    /** \brief Generate machine code for the numerical evaluation (eval_t signature) */
+    virtual std::vector<unsigned char> native_code() const;
+
     /** \brief Export function in a specific language */
     virtual void export_code(const std::string& lang,
       std::ostream &stream, const Dict& options) const;
@@ -659,6 +714,9 @@ namespace casadi {
     /** \brief Print free variables */
     virtual std::vector<std::string> get_free() const;
 
+    /** \brief Unidirectional coloring of the columns of A, using the 'coloring' option */
+    Sparsity uni_coloring(const Sparsity& A, const Sparsity& AT, casadi_int cutoff) const;
+
     /** \brief Get the unidirectional or bidirectional partition */
     void get_partition(casadi_int iind, casadi_int oind, Sparsity& D1, Sparsity& D2,
                       bool compact, bool symmetric,
@@ -723,6 +781,10 @@ namespace casadi {
     /// Get, if necessary generate, the sparsity of a Jacobian block
     Sparsity& sparsity_jac(casadi_int iind, casadi_int oind, bool compact, bool symmetric) const;
 
+    /// Hash of the serialized function, key in the on-disk sparsity cache
+    /// (empty if not serializable)
+    const std::string& structure_hash() const;
+
     /// Filter out nonzeros in the full sparsity jacobian according to is_diff_in/out
     Sparsity jacobian_sparsity_filter(const Sparsity& sp) const;
 
@@ -888,6 +950,12 @@ namespace casadi {
     /** \brief Use a temporary name */
     bool jit_temp_suffix_;
 
+    /** \brief Maximum number of instructions per generated file, 0 for no splitting */
+    casadi_int jit_chunk_size_;
+
+    /** \brief Additional jit source files */
+    std::vector<std::string> jit_sources_;
+
     /** \brief Numerical evaluation redirected to a C function */
     eval_t eval_;
 
@@ -912,6 +980,10 @@ namespace casadi {
     /// Cache for sparsities of the Jacobian blocks
     mutable SparseStorage<Sparsity> jac_sparsity_, jac_sparsity_compact_;
 
+    /// Cache for structure_hash, calculated at most once
+    mutable std::string structure_hash_;
+    mutable bool has_structure_hash_;
+
     /// Cache for full Jacobian sparsity
     mutable Sparsity jacobian_sparsity_;
 
@@ -929,6 +1001,10 @@ namespace casadi {
     /// Penalty factor for using a complete Jacobian to calculate directional derivatives
     double jac_penalty_;
 
+    // Graph coloring algorithm for the Jacobian/Hessian seeds and number of recoloring passes
+    std::string coloring_;
+    casadi_int coloring_recolor_;
+
     // Types of derivative calculation permitted
     bool enable_forward_, enable_reverse_, enable_jacobian_, enable_fd_;
     bool enable_forward_op_, enable_reverse_op_, enable_jacobian_op_, enable_fd_op_;
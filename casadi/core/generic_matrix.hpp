@@ -745,6 +745,21 @@ namespace casadi {
       shared(ex_output, v, vdef, v_prefix, v_suffix);
     }
 
+    ///@{
+    /** \brief Common subexpression elimination
+
+        Structurally identical subexpressions, i.e. with the same operation,
+        the same dependencies and the same constant value, are merged into
+        a single node.
+    */
+    inline friend std::vector<MatType> cse(const std::vector<MatType>& e) {
+      return MatType::cse(e);
+    }
+    inline friend MatType cse(const MatType& e) {
+      return MatType::cse(e);
+    }
+    ///@}
+
     /** \brief Given a repeated matrix, computes the sum of repeated parts
      */
     inline friend MatType repsum(const MatType &A, casadi_int n, casadi_int m=1) {
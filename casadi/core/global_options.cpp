@@ -30,12 +30,19 @@ namespace casadi {
 
   bool GlobalOptions::simplification_on_the_fly = true;
   bool GlobalOptions::hierarchical_sparsity = true;
+  bool GlobalOptions::parallel_sparsity = false;
 
   std::string GlobalOptions::casadipath;
   std::string GlobalOptions::casadi_include_path;
 
   casadi_int GlobalOptions::max_num_dir = 64;
 
+  // By default, use all hardware threads
+  casadi_int GlobalOptions::max_num_threads = 0;
+
+  // By default, do not cache sparsity patterns on disk
+  std::string GlobalOptions::sparsity_cache_dir;
+
   // By default, use zero-based indexing
   casadi_int GlobalOptions::start_index = 0;
 
@@ -64,10 +64,16 @@ namespace casadi {
 
       static bool hierarchical_sparsity;
 
+      static bool parallel_sparsity;
+
       static casadi_int max_num_dir;
 
       static casadi_int start_index;
 
+      static casadi_int max_num_threads;
+
+      static std::string sparsity_cache_dir;
+
 #endif //SWIG
       // Setter and getter for simplification_on_the_fly
       static void setSimplificationOnTheFly(bool flag) { simplification_on_the_fly = flag; }
@@ -77,6 +83,12 @@ namespace casadi {
       static void setHierarchicalSparsity(bool flag) { hierarchical_sparsity = flag; }
       static bool getHierarchicalSparsity() { return hierarchical_sparsity; }
 
+      // Setter and getter for parallel_sparsity
+      // Distribute the sweeps of Jacobian sparsity detection over the thread pool.
+      // Requires sp_forward/sp_reverse to be thread-safe (not the case for Python callbacks)
+      static void setParallelSparsity(bool flag) { parallel_sparsity = flag; }
+      static bool getParallelSparsity() { return parallel_sparsity; }
+
       static void setCasadiPath(const std::string & path) { casadipath = path; }
       static std::string getCasadiPath() { return casadipath; }
 
@@ -86,6 +98,16 @@ namespace casadi {
       static void setMaxNumDir(casadi_int ndir) { max_num_dir=ndir; }
       static casadi_int getMaxNumDir() { return max_num_dir; }
 
+      // Number of threads used for parallel evaluation (0: hardware concurrency)
+      // Read when the thread pool is first used
+      static void setMaxNumThreads(casadi_int n) { max_num_threads=n; }
+      static casadi_int getMaxNumThreads() { return max_num_threads; }
+
+      // Directory of the on-disk cache of Jacobian sparsity patterns and colorings
+      // (empty: disabled). The directory must exist
+      static void setSparsityCacheDir(const std::string & dir) { sparsity_cache_dir = dir; }
+      static std::string getSparsityCacheDir() { return sparsity_cache_dir; }
+
   };
 
 } // namespace casadi
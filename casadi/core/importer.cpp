@@ -39,6 +39,8 @@ namespace casadi {
       own(new ImporterInternal(name));
     } else if (compiler=="dll") {
       own(new DllLibrary(name));
+    } else if (compiler=="native") {
+      own(new NativeLibrary(name));
     } else {
       own(ImporterInternal::getPlugin(compiler).creator(name));
     }
@@ -101,6 +103,10 @@ namespace casadi {
     return (*this)->library();
   }
 
+  Dict Importer::get_stats() const {
+    return (*this)->get_stats();
+  }
+
   void Importer::serialize(SerializingStream &s) const {
     return (*this)->serialize(s);
   }
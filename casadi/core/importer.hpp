@@ -141,6 +141,9 @@ namespace casadi {
     /// Get library name
     std::string library() const;
 
+    /// Get statistics, e.g. compilation cache hits
+    Dict get_stats() const;
+
 #ifndef SWIG
     /** Convert indexed command */
     static inline std::string indexed(const std::string& cmd, casadi_int ind) {
@@ -25,6 +25,10 @@
 
 #include "importer_internal.hpp"
 
+#ifdef CASADI_WITH_NATIVE_JIT
+#include <sys/mman.h>
+#endif // CASADI_WITH_NATIVE_JIT
+
 using namespace std;
 namespace casadi {
 
@@ -270,6 +274,45 @@ namespace casadi {
 #endif // WITH_DL
   }
 
+  NativeLibrary::~NativeLibrary() {
+#ifdef CASADI_WITH_NATIVE_JIT
+    for (auto&& c : code_) munmap(c.second.first, c.second.second);
+#endif // CASADI_WITH_NATIVE_JIT
+  }
+
+  bool NativeLibrary::is_supported() {
+#ifdef CASADI_WITH_NATIVE_JIT
+    return true;
+#else // CASADI_WITH_NATIVE_JIT
+    return false;
+#endif // CASADI_WITH_NATIVE_JIT
+  }
+
+  void NativeLibrary::add(const std::string& symname, const std::vector<unsigned char>& code) {
+#ifdef CASADI_WITH_NATIVE_JIT
+    casadi_assert(code_.find(symname)==code_.end(), "Duplicate symbol \"" + symname + "\"");
+    casadi_assert(!code.empty(), "No machine code for \"" + symname + "\"");
+    // Allocate writable memory, fill it, then make it executable
+    void* ptr = mmap(nullptr, code.size(), PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    casadi_assert(ptr!=MAP_FAILED, "Failed to allocate memory for \"" + symname + "\"");
+    std::copy(code.begin(), code.end(), static_cast<unsigned char*>(ptr));
+    if (mprotect(ptr, code.size(), PROT_READ | PROT_EXEC)) {
+      munmap(ptr, code.size());
+      casadi_error("Failed to make memory executable for \"" + symname + "\"");
+    }
+    code_[symname] = make_pair(ptr, code.size());
+#else // CASADI_WITH_NATIVE_JIT
+    casadi_error("Native just-in-time compilation requires x86-64 with the System V ABI");
+#endif // CASADI_WITH_NATIVE_JIT
+  }
+
+  signal_t NativeLibrary::get_function(const std::string& symname) {
+    auto it = code_.find(symname);
+    if (it==code_.end()) return nullptr;
+    return reinterpret_cast<signal_t>(it->second.first);
+  }
+
   std::string ImporterInternal::get_meta(const std::string& cmd, casadi_int ind) const {
     if (ind>=0) return get_meta(indexed(cmd, ind));
     casadi_assert(has_meta(cmd), "No such command: " + cmd);
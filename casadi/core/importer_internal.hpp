@@ -30,6 +30,10 @@
 #include "function_internal.hpp"
 #include "plugin_interface.hpp"
 
+// In-process machine code generation, see NativeLibrary
+#if defined(__x86_64__) && !defined(_WIN32)
+#define CASADI_WITH_NATIVE_JIT
+#endif // defined(__x86_64__) && !defined(_WIN32)
 
 /// \cond INTERNAL
 namespace casadi {
@@ -119,6 +123,9 @@ namespace casadi {
     /// Get library name
     virtual std::string library() const;
 
+    /// Get statistics
+    virtual Dict get_stats() const { return Dict();}
+
     /// Can meta information be read?
     virtual bool can_have_meta() const { return true;}
 
@@ -198,6 +205,43 @@ namespace casadi {
     explicit DllLibrary(DeserializingStream& s) : ImporterInternal(s) {}
   };
 
+  /** \brief Machine code generated in-process
+      Holds executable memory for functions that were translated directly
+      to machine code, without going through a C compiler
+  */
+  class CASADI_EXPORT
+  NativeLibrary : public ImporterInternal {
+  public:
+
+    // Constructor
+    explicit NativeLibrary(const std::string& name) : ImporterInternal(name) {}
+
+    // Destructor
+    ~NativeLibrary() override;
+
+    /** \brief Get type name */
+    std::string class_name() const override { return "NativeLibrary";}
+
+    /// Queery plugin name
+    const char* plugin_name() const override { return "native";}
+
+    /// Get a function pointer for numerical evaluation
+    signal_t get_function(const std::string& symname) override;
+
+    /// Can meta information be read?
+    bool can_have_meta() const override { return false;}
+
+    /// Copy machine code to executable memory and register it as a symbol
+    void add(const std::string& symname, const std::vector<unsigned char>& code);
+
+    /// Is in-process machine code generation supported on this platform?
+    static bool is_supported();
+
+  private:
+    /// Executable memory blocks and their sizes
+    std::map<std::string, std::pair<void*, size_t> > code_;
+  };
+
 } // namespace casadi
 /// \endcond
 #endif // CASADI_IMPORTER_INTERNAL_HPP
@@ -25,14 +25,8 @@
 
 #include "map.hpp"
 #include "serializing_stream.hpp"
-
-#ifdef CASADI_WITH_THREAD
-#ifdef CASADI_WITH_THREAD_MINGW
-#include <mingw.thread.h>
-#else // CASADI_WITH_THREAD_MINGW
-#include <thread>
-#endif // CASADI_WITH_THREAD_MINGW
-#endif // CASADI_WITH_THREAD
+#include "sx_function.hpp"
+#include "thread_pool.hpp"
 
 using namespace std;
 
@@ -47,6 +41,10 @@ namespace casadi {
       return Function::create(new OmpMap("ompmap" + suffix, f, n), Dict());
     } else if (parallelization== "thread") {
       return Function::create(new ThreadMap("threadmap" + suffix, f, n), Dict());
+    } else if (parallelization== "simd") {
+      // Batched evaluation requires the SXFunction virtual machine
+      if (!f.is_a("SXFunction")) return create("serial", f, n);
+      return Function::create(new SimdMap("simdmap" + suffix, f, n), Dict());
     } else {
       casadi_error("Unknown parallelization: " + parallelization);
     }
@@ -71,6 +69,11 @@ namespace casadi {
       || (recursive && Map::is_a(type, recursive));
   }
 
+  bool SimdMap::is_a(const std::string& type, bool recursive) const {
+    return type=="SimdMap"
+      || (recursive && Map::is_a(type, recursive));
+  }
+
  std::vector<std::string> Map::get_function() const {
     return {"f"};
   }
@@ -111,6 +114,8 @@ namespace casadi {
       return new OmpMap(s);
     } else if (class_name=="ThreadMap") {
       return new ThreadMap(s);
+    } else if (class_name=="SimdMap") {
+      return new SimdMap(s);
     } else {
       casadi_error("class name '" + class_name + "' unknown.");
     }
@@ -328,6 +333,10 @@ namespace casadi {
 #else // WITH_OPENMP
     size_t sz_arg, sz_res, sz_iw, sz_w;
     f_.sz_work(sz_arg, sz_res, sz_iw, sz_w);
+    sz_arg = padded_stride(sz_arg);
+    sz_res = padded_stride(sz_res);
+    sz_iw = padded_stride(sz_iw);
+    sz_w = padded_stride(sz_w);
 
     // Error flag
     casadi_int flag = 0;
@@ -369,27 +378,58 @@ namespace casadi {
 #endif  // WITH_OPENMP
   }
 
+  size_t OmpMap::padded_stride(size_t sz) {
+    // Elements are 8 bytes (double, casadi_int or pointer), 8 per cache line
+    return (sz + 15) / 8 * 8;
+  }
+
+  void OmpMap::codegen_num_threads(CodeGenerator& g, casadi_int n) {
+    g.add_include("omp.h", false, "_OPENMP");
+    g << "#ifdef _OPENMP\n"
+      << "int nt = omp_get_max_threads();\n"
+      << "if (nt>" << n << ") nt = " << n << ";\n"
+      << "#endif\n";
+  }
+
+  void OmpMap::codegen_thread_num(CodeGenerator& g) {
+    g << "#ifdef _OPENMP\n"
+      << "t = omp_get_thread_num();\n"
+      << "#else\n"
+      << "t = 0;\n"
+      << "#endif\n";
+  }
+
   void OmpMap::codegen_body(CodeGenerator& g) const {
+    // One slice of the work vectors per thread
     size_t sz_arg, sz_res, sz_iw, sz_w;
     f_.sz_work(sz_arg, sz_res, sz_iw, sz_w);
-    g << "casadi_int i;\n"
+    sz_arg = padded_stride(sz_arg);
+    sz_res = padded_stride(sz_res);
+    sz_iw = padded_stride(sz_iw);
+    sz_w = padded_stride(sz_w);
+    g << "casadi_int i, t;\n"
       << "const double** arg1;\n"
       << "double** res1;\n"
-      << "casadi_int flag = 0;\n"
-      << "#pragma omp parallel for private(i,arg1,res1) reduction(||:flag)\n"
-      << "for (i=0; i<" << n_ << "; ++i) {\n"
-      << "arg1 = arg + " << n_in_ << "+i*" << sz_arg << ";\n";
+      << "casadi_int flag = 0;\n";
+    codegen_num_threads(g, n_);
+    g << "#pragma omp parallel private(i,t,arg1,res1) reduction(||:flag) num_threads(nt)\n"
+      << "{\n";
+    codegen_thread_num(g);
+    g << "arg1 = arg + " << n_in_ << "+t*" << sz_arg << ";\n"
+      << "res1 = res + " <<  n_out_ << "+t*" <<  sz_res << ";\n"
+      << "#pragma omp for" << g.omp_schedule() << "\n"
+      << "for (i=0; i<" << n_ << "; ++i) {\n";
     for (casadi_int j=0; j<n_in_; ++j) {
       g << "arg1[" << j << "] = arg[" << j << "] ? "
         << g.arg(j) << "+i*" << f_.nnz_in(j) << ": 0;\n";
     }
-    g << "res1 = res + " <<  n_out_ << "+i*" <<  sz_res << ";\n";
     for (casadi_int j=0; j<n_out_; ++j) {
       g << "res1[" << j << "] = res[" << j << "] ?"
         << g.res(j) << "+i*" << f_.nnz_out(j) << ": 0;\n";
     }
     g << "flag = "
-      << g(f_, "arg1", "res1", "iw+i*" + str(sz_iw), "w+i*" + str(sz_w)) << " || flag;\n"
+      << g(f_, "arg1", "res1", "iw+t*" + str(sz_iw), "w+t*" + str(sz_w)) << " || flag;\n"
+      << "}\n"
       << "}\n"
       << "if (flag) return 1;\n";
   }
@@ -406,10 +446,10 @@ namespace casadi {
     alloc_iw(n_, true);
 
     // Allocate sufficient memory for parallel evaluation
-    alloc_arg(f_.sz_arg() * n_);
-    alloc_res(f_.sz_res() * n_);
-    alloc_w(f_.sz_w() * n_);
-    alloc_iw(f_.sz_iw() * n_);
+    alloc_arg(padded_stride(f_.sz_arg()) * n_);
+    alloc_res(padded_stride(f_.sz_res()) * n_);
+    alloc_w(padded_stride(f_.sz_w()) * n_);
+    alloc_iw(padded_stride(f_.sz_iw()) * n_);
   }
 
 
@@ -466,22 +506,10 @@ namespace casadi {
     // Allocate space for return values
     std::vector<int> ret_values(n_);
 
-    // Spawn threads
-    std::vector<std::thread> threads;
-    for (casadi_int i=0; i<n_; ++i) {
-      // Why the lambda function?
-      // Because it was the first iteration to pass tests on MingGW
-      // using mingw-std-threads.
-      threads.emplace_back(
-        [i](const Function& f, const double** arg, double** res,
-            casadi_int* iw, double* w, casadi_int ind, int& ret) {
-              ThreadsWork(f, i, arg, res, iw, w, ind, ret);
-            },
-        std::ref(f_), arg, res, iw, w, casadi_int(ind[i]), std::ref(ret_values[i]));
-    }
-
-    // Join threads
-    for (auto && th : threads) th.join();
+    // Evaluate in the process-wide thread pool
+    ThreadPool::instance().parallel_for(n_, [&](casadi_int i) {
+      ThreadsWork(f_, i, arg, res, iw, w, ind[i], ret_values[i]);
+    });
 
     // Anticipate success
     int ret = 0;
@@ -515,4 +543,52 @@ namespace casadi {
     alloc_iw(f_.sz_iw() * n_);
   }
 
+  const casadi_int SimdMap::max_batch;
+
+  SimdMap::~SimdMap() {
+    clear_mem();
+  }
+
+  SimdMap::SimdMap(DeserializingStream& s) : Map(s) {
+    s.unpack("SimdMap::batch", batch_);
+  }
+
+  void SimdMap::serialize_body(SerializingStream &s) const {
+    Map::serialize_body(s);
+    s.pack("SimdMap::batch", batch_);
+  }
+
+  void SimdMap::init(const Dict& opts) {
+    // Call the initialization method of the base class
+    Map::init(opts);
+
+    // Number of instances per sweep
+    batch_ = std::min(n_, max_batch);
+
+    // Structure-of-arrays work vector for one batch
+    alloc_w(f_.sz_w() * batch_);
+  }
+
+  int SimdMap::eval(const double** arg, double** res, casadi_int* iw, double* w,
+      void* mem) const {
+    const SXFunction* f = static_cast<const SXFunction*>(f_.get());
+
+    // Input and output buffers
+    const double** arg1 = arg+n_in_;
+    double** res1 = res+n_out_;
+
+    // Evaluate batch by batch
+    for (casadi_int i=0; i<n_; i+=batch_) {
+      casadi_int nb = std::min(batch_, n_-i);
+      for (casadi_int j=0; j<n_in_; ++j) {
+        arg1[j] = arg[j] ? arg[j] + i*f_.nnz_in(j) : nullptr;
+      }
+      for (casadi_int j=0; j<n_out_; ++j) {
+        res1[j] = res[j] ? res[j] + i*f_.nnz_out(j) : nullptr;
+      }
+      if (f->eval_simd(arg1, res1, w, nb)) return 1;
+    }
+    return 0;
+  }
+
 } // namespace casadi
@@ -204,12 +204,26 @@ namespace casadi {
     /** \brief Generate code for the body of the C function */
     void codegen_body(CodeGenerator& g) const override;
 
+    /** \brief Stride between thread-local work slices
+
+        Rounds up to a whole number of 64-byte cache lines and adds one line
+        of separation, so that no two slices share a cache line regardless
+        of the alignment of the work vector.
+    */
+    static size_t padded_stride(size_t sz);
+
+    /** \brief Generate code for the number of threads "nt" for n iterations */
+    static void codegen_num_threads(CodeGenerator& g, casadi_int n);
+
+    /** \brief Generate code for the index "t" of the current thread */
+    static void codegen_thread_num(CodeGenerator& g);
+
   protected:
     /** \brief Deserializing constructor */
     explicit OmpMap(DeserializingStream& s) : Map(s) {}
   };
 
-  /** A map Evaluate in parallel using std::thread
+  /** A map Evaluate in parallel using the process-wide ThreadPool
       Note: Do not use this class with much more than the intended number of
       threads for the parallel evaluation as it will cause excessive memory use.
 
@@ -248,6 +262,51 @@ namespace casadi {
     explicit ThreadMap(DeserializingStream& s) : Map(s) {}
   };
 
+  /** A map Evaluate an SXFunction in SIMD lanes
+      The instances are evaluated in batches of up to max_batch lanes. Each
+      instruction of the SXFunction algorithm is dispatched once per batch and
+      applied to all lanes, with lane j of work element k stored at
+      w[k*batch+j]. The inner loop over the lanes is thus contiguous and can be
+      vectorized by the compiler. Generated code is that of the serial map.
+  */
+  class CASADI_EXPORT SimdMap : public Map {
+    friend class Map;
+  public:
+    // Constructor (protected, use create function in Map)
+    SimdMap(const std::string& name, const Function& f, casadi_int n) : Map(name, f, n) {}
+
+    /** \brief  Destructor */
+    ~SimdMap() override;
+
+    /** \brief Get type name */
+    std::string class_name() const override {return "SimdMap";}
+
+    /** \brief Check if the function is of a particular type */
+    bool is_a(const std::string& type, bool recursive) const override;
+
+    /// Evaluate the function numerically
+    int eval(const double** arg, double** res, casadi_int* iw, double* w, void* mem) const override;
+
+    /** \brief  Initialize */
+    void init(const Dict& opts) override;
+
+    /// Type of parallellization
+    std::string parallelization() const override { return "simd"; }
+
+    /** \brief Serialize an object without type information */
+    void serialize_body(SerializingStream &s) const override;
+
+    /// Maximum number of instances evaluated in one sweep
+    static const casadi_int max_batch = 64;
+
+  protected:
+    /** \brief Deserializing constructor */
+    explicit SimdMap(DeserializingStream& s);
+
+    // Number of instances evaluated in one sweep
+    casadi_int batch_;
+  };
+
 } // namespace casadi
 /// \endcond
 
@@ -24,6 +24,7 @@
 
 
 #include "mapsum.hpp"
+#include "map.hpp"
 #include "serializing_stream.hpp"
 
 using namespace std;
@@ -40,12 +41,17 @@ namespace casadi {
     casadi_assert(reduce_in.size()==f.n_in(), "Dimension mismatch");
     casadi_assert(reduce_out.size()==f.n_out(), "Dimension mismatch");
 
-    if (parallelization == "serial") {
+    if (parallelization == "serial" || parallelization == "openmp") {
       string suffix = str(reduce_in)+str(reduce_out);
+      if (parallelization == "openmp") suffix += "_openmp";
       Function ret;
       if (!f->incache(name, ret, suffix)) {
-        // Create new serial map
-        ret = Function::create(new MapSum(name, f, n, reduce_in, reduce_out), opts);
+        // Create new map
+        if (parallelization == "serial") {
+          ret = Function::create(new MapSum(name, f, n, reduce_in, reduce_out), opts);
+        } else {
+          ret = Function::create(new OmpMapSum(name, f, n, reduce_in, reduce_out), opts);
+        }
         casadi_assert_dev(ret.name()==name);
         // Save in cache
         f->tocache(ret, suffix);
@@ -89,6 +95,8 @@ namespace casadi {
     s.unpack("MapSum::class_name", class_name);
     if (class_name=="MapSum") {
       return new MapSum(s);
+    } else if (class_name=="OmpMapSum") {
+      return new OmpMapSum(s);
     } else {
       casadi_error("class name '" + class_name + "' unknown.");
     }
@@ -399,4 +407,176 @@ namespace casadi {
     return eval_gen(arg, res, iw, w, m);
   }
 
+  OmpMapSum::~OmpMapSum() {
+    clear_mem();
+  }
+
+  casadi_int OmpMapSum::nnz_reduced() const {
+    casadi_int ret = 0;
+    for (casadi_int j=0; j<n_out_; ++j) {
+      if (reduce_out_[j]) ret += f_.nnz_out(j);
+    }
+    return ret;
+  }
+
+  void OmpMapSum::init(const Dict& opts) {
+    // Call the initialization method of the base class
+    MapSum::init(opts);
+
+    // Allocate memory for holding memory object references
+    alloc_iw(n_, true);
+
+    // One slice per thread: work of f, reduced outputs and partial sums
+    alloc_arg(OmpMap::padded_stride(f_.sz_arg()) * n_);
+    alloc_res(OmpMap::padded_stride(f_.sz_res()) * n_);
+    alloc_w(OmpMap::padded_stride(f_.sz_w() + 2*nnz_reduced()) * n_);
+    alloc_iw(OmpMap::padded_stride(f_.sz_iw()) * n_);
+  }
+
+  int OmpMapSum::eval(const double** arg, double** res, casadi_int* iw, double* w,
+                      void* mem) const {
+#ifndef WITH_OPENMP
+    return MapSum::eval(arg, res, iw, w, mem);
+#else // WITH_OPENMP
+    size_t sz_arg, sz_res, sz_iw, sz_w;
+    f_.sz_work(sz_arg, sz_res, sz_iw, sz_w);
+    size_t stride_arg = OmpMap::padded_stride(sz_arg);
+    size_t stride_res = OmpMap::padded_stride(sz_res);
+    size_t stride_iw = OmpMap::padded_stride(sz_iw);
+    size_t stride_w = OmpMap::padded_stride(sz_w + 2*nnz_reduced());
+
+    // Error flag
+    casadi_int flag = 0;
+
+    // Checkout memory objects
+    std::vector< scoped_checkout<Function> > ind; ind.reserve(n_);
+    for (casadi_int i=0; i<n_; ++i) ind.emplace_back(f_);
+
+    // Evaluate in parallel, reduced outputs in the slice of the iteration
+#pragma omp parallel for reduction(||:flag)
+    for (casadi_int i=0; i<n_; ++i) {
+      double* w1 = w + i*stride_w;
+      const double** arg1 = arg + n_in_ + i*stride_arg;
+      for (casadi_int j=0; j<n_in_; ++j) {
+        if (!arg[j]) {
+          arg1[j] = 0;
+        } else {
+          arg1[j] = reduce_in_[j] ? arg[j] : arg[j] + i*f_.nnz_in(j);
+        }
+      }
+      double** res1 = res + n_out_ + i*stride_res;
+      double* w_scratch = w1 + sz_w;
+      for (casadi_int j=0; j<n_out_; ++j) {
+        if (!res[j]) {
+          res1[j] = 0;
+        } else if (reduce_out_[j]) {
+          res1[j] = w_scratch;
+        } else {
+          res1[j] = res[j] + i*f_.nnz_out(j);
+        }
+        if (reduce_out_[j]) w_scratch += f_.nnz_out(j);
+      }
+      try {
+        flag = f_(arg1, res1, iw + i*stride_iw, w1, ind[i]) || flag;
+      } catch (std::exception& e) {
+        flag = 1;
+        casadi_warning("Exception raised: " + std::string(e.what()));
+      } catch (...) {
+        flag = 1;
+        casadi_warning("Uncaught exception.");
+      }
+    }
+
+    // Sum up in the order of the iterations
+    casadi_int offset = sz_w;
+    for (casadi_int j=0; j<n_out_; ++j) {
+      if (!reduce_out_[j]) continue;
+      if (res[j]) {
+        casadi_clear(res[j], f_.nnz_out(j));
+        for (casadi_int i=0; i<n_; ++i) {
+          casadi_add(f_.nnz_out(j), w + i*stride_w + offset, res[j]);
+        }
+      }
+      offset += f_.nnz_out(j);
+    }
+
+    // Return error flag
+    return flag;
+#endif  // WITH_OPENMP
+  }
+
+  void OmpMapSum::codegen_body(CodeGenerator& g) const {
+    g.add_auxiliary(CodeGenerator::AUX_CLEAR);
+    // One slice of the work vectors per thread
+    size_t sz_arg, sz_res, sz_iw, sz_w;
+    f_.sz_work(sz_arg, sz_res, sz_iw, sz_w);
+    casadi_int nnz_red = nnz_reduced();
+    size_t stride_arg = OmpMap::padded_stride(sz_arg);
+    size_t stride_res = OmpMap::padded_stride(sz_res);
+    size_t stride_iw = OmpMap::padded_stride(sz_iw);
+    size_t stride_w = OmpMap::padded_stride(sz_w + 2*nnz_red);
+    g << "casadi_int i, t, nt1 = 1;\n"
+      << "const casadi_real** arg1;\n"
+      << "casadi_real** res1;\n"
+      << "casadi_real* w1;\n"
+      << "casadi_int flag = 0;\n";
+    OmpMap::codegen_num_threads(g, n_);
+    g << "#pragma omp parallel private(i,t,arg1,res1,w1) reduction(||:flag) num_threads(nt)\n"
+      << "{\n";
+    g << "#ifdef _OPENMP\n"
+      << "t = omp_get_thread_num();\n"
+      << "if (t==0) nt1 = omp_get_num_threads();\n"
+      << "#else\n"
+      << "t = 0;\n"
+      << "#endif\n"
+      << "arg1 = arg + " << n_in_ << "+t*" << stride_arg << ";\n"
+      << "res1 = res + " << n_out_ << "+t*" << stride_res << ";\n"
+      << "w1 = w+t*" << stride_w << ";\n";
+    // Clear the partial sums of the thread
+    if (nnz_red>0) g << g.clear("w1+" + str(sz_w + nnz_red), nnz_red) << "\n";
+    g << "#pragma omp for" << g.omp_schedule() << "\n"
+      << "for (i=0; i<" << n_ << "; ++i) {\n";
+    for (casadi_int j=0; j<n_in_; ++j) {
+      g << "arg1[" << j << "] = arg[" << j << "] ? " << g.arg(j);
+      if (!reduce_in_[j]) g << "+i*" << f_.nnz_in(j);
+      g << ": 0;\n";
+    }
+    casadi_int offset = sz_w;
+    for (casadi_int j=0; j<n_out_; ++j) {
+      if (reduce_out_[j]) {
+        g << "res1[" << j << "] = res[" << j << "] ? w1+" << offset << ": 0;\n";
+        offset += f_.nnz_out(j);
+      } else {
+        g << "res1[" << j << "] = res[" << j << "] ? "
+          << g.res(j) << "+i*" << f_.nnz_out(j) << ": 0;\n";
+      }
+    }
+    g << "flag = "
+      << g(f_, "arg1", "res1", "iw+t*" + str(stride_iw), "w1") << " || flag;\n";
+    // Accumulate into the partial sums
+    offset = sz_w;
+    for (casadi_int j=0; j<n_out_; ++j) {
+      if (!reduce_out_[j]) continue;
+      g << "if (res1[" << j << "]) "
+        << g.axpy(f_.nnz_out(j), "1.0", "res1[" + str(j) + "]",
+                  "w1+" + str(offset + nnz_red)) << "\n";
+      offset += f_.nnz_out(j);
+    }
+    g << "}\n"
+      << "}\n"
+      << "if (flag) return 1;\n";
+    // Add up the partial sums of the threads
+    offset = sz_w + nnz_red;
+    for (casadi_int j=0; j<n_out_; ++j) {
+      if (!reduce_out_[j]) continue;
+      g << "if (res[" << j << "]) {\n"
+        << g.clear(g.res(j), f_.nnz_out(j)) << "\n"
+        << "for (t=0; t<nt1; ++t) "
+        << g.axpy(f_.nnz_out(j), "1.0", "w+t*" + str(stride_w) + "+" + str(offset), g.res(j))
+        << "\n"
+        << "}\n";
+      offset += f_.nnz_out(j);
+    }
+  }
+
 } // namespace casadi
@@ -178,6 +178,47 @@ namespace casadi {
     std::vector<bool> reduce_out_;
   };
 
+  /** A mapsum evaluated in parallel with OpenMP
+
+      Each thread evaluates into its own cache-line separated slice of the
+      work vectors and accumulates the reduced outputs into thread-local
+      partial sums, which are added up after the parallel loop.
+  */
+  class CASADI_EXPORT OmpMapSum : public MapSum {
+    friend class MapSum;
+  public:
+    /** \brief Destructor */
+    ~OmpMapSum() override;
+
+    /** \brief Get type name */
+    std::string class_name() const override {return "OmpMapSum";}
+
+    /// Evaluate the function numerically
+    int eval(const double** arg, double** res, casadi_int* iw, double* w, void* mem) const override;
+
+    /// Type of parallellization
+    std::string parallelization() const override { return "openmp"; }
+
+    /** \brief Generate code for the body of the C function */
+    void codegen_body(CodeGenerator& g) const override;
+
+    /** \brief  Initialize */
+    void init(const Dict& opts) override;
+
+  protected:
+    /** \brief Deserializing constructor */
+    explicit OmpMapSum(DeserializingStream& s) : MapSum(s) {}
+
+    // Constructor (protected, use create function in MapSum)
+    OmpMapSum(const std::string& name, const Function& f, casadi_int n,
+              const std::vector<bool>& reduce_in,
+              const std::vector<bool>& reduce_out)
+      : MapSum(name, f, n, reduce_in, reduce_out) {}
+
+    // Number of nonzeros of the reduced outputs
+    casadi_int nnz_reduced() const;
+  };
+
 
 } // namespace casadi
 /// \endcond
@@ -2580,6 +2580,17 @@ namespace casadi {
     casadi_error("'shared' not defined for " + type_name());
   }
 
+  template<typename Scalar>
+  std::vector<Matrix<Scalar> > Matrix<Scalar>::cse(const std::vector<Matrix<Scalar> >& e) {
+    // Nothing to eliminate for numerical types
+    return e;
+  }
+
+  template<typename Scalar>
+  Matrix<Scalar> Matrix<Scalar>::cse(const Matrix<Scalar>& e) {
+    return cse(std::vector<Matrix<Scalar> >{e}).front();
+  }
+
   template<typename Scalar>
   Matrix<Scalar> Matrix<Scalar>::poly_coeff(const Matrix<Scalar>& f,
                                                 const Matrix<Scalar>&x) {
@@ -59,17 +59,68 @@ namespace casadi {
     return eval_gen<SXElem>(arg, res, iw, w);
   }
 
+  Multiplication::Kernel Multiplication::kernel() const {
+    if (!dep(2).is_dense() || !sparsity().is_dense()) return MTIMES_SPARSE;
+    return dep(1).is_dense() ? MTIMES_DENSE : MTIMES_SPARSE_DENSE;
+  }
+
   template<typename T>
   int Multiplication::eval_gen(const T** arg, T** res, casadi_int* iw, T* w) const {
     if (arg[0]!=res[0]) copy(arg[0], arg[0]+dep(0).nnz(), res[0]);
-    casadi_mtimes(arg[1], dep(1).sparsity(),
-               arg[2], dep(2).sparsity(),
-               res[0], sparsity(), w, false);
+    switch (kernel()) {
+    case MTIMES_DENSE:
+      casadi_mtimes_dense(arg[1], dep(1).size1(), dep(1).size2(),
+                          arg[2], dep(2).size2(), res[0]);
+      break;
+    case MTIMES_SPARSE_DENSE:
+      casadi_mtimes_sparse_dense(arg[1], dep(1).sparsity(),
+                                 arg[2], dep(2).size2(), res[0]);
+      break;
+    default:
+      casadi_mtimes(arg[1], dep(1).sparsity(),
+                 arg[2], dep(2).sparsity(),
+                 res[0], sparsity(), w, false);
+    }
     return 0;
   }
 
+  // Directional derivatives are batched in the nodes that share an operand
+  // between the directions: Multiplication (below) and Solve, which solves
+  // for all right-hand sides at once. Nodes without a shared operand, such as
+  // GetNonzeros, are left per direction, since stacking the seeds would only
+  // add concatenation and splitting copies around the same gather.
+
+  // Can the seeds of all directions be stacked (same dimensions as the operands)?
+  static bool stackable(const std::vector<std::vector<MX> >& seed, casadi_int i,
+                        const MX& ref) {
+    if (seed.size()<=1) return false;
+    for (auto&& s : seed) {
+      if (s[i].size()!=ref.size()) return false;
+    }
+    return true;
+  }
+
   void Multiplication::ad_forward(const std::vector<std::vector<MX> >& fseed,
                                std::vector<std::vector<MX> >& fsens) const {
+    casadi_int nfwd = fsens.size();
+    if (stackable(fseed, 1, dep(1)) && stackable(fseed, 2, dep(2))) {
+      // Multiply for all directions at once: x*[y_hat_1, ..., y_hat_n]
+      // and [x_hat_1; ...; x_hat_n]*y
+      vector<MX> x_hat(nfwd), y_hat(nfwd);
+      for (casadi_int d=0; d<nfwd; ++d) {
+        x_hat[d] = fseed[d][1];
+        y_hat[d] = fseed[d][2];
+      }
+      const Sparsity& sp = dep(0).sparsity();
+      vector<MX> xy_hat = horzsplit(mac(dep(1), horzcat(y_hat),
+                                        MX::zeros(repmat(sp, 1, nfwd))), sp.size2());
+      vector<MX> x_haty = vertsplit(mac(vertcat(x_hat), dep(2),
+                                        MX::zeros(repmat(sp, nfwd, 1))), sp.size1());
+      for (casadi_int d=0; d<nfwd; ++d) {
+        fsens[d][0] = fseed[d][0] + xy_hat[d] + x_haty[d];
+      }
+      return;
+    }
     for (casadi_int d=0; d<fsens.size(); ++d) {
       fsens[d][0] = fseed[d][0]
         + mac(dep(1), fseed[d][2], MX::zeros(dep(0).sparsity()))
@@ -79,6 +130,25 @@ namespace casadi {
 
   void Multiplication::ad_reverse(const std::vector<std::vector<MX> >& aseed,
                                std::vector<std::vector<MX> >& asens) const {
+    casadi_int nadj = aseed.size();
+    if (stackable(aseed, 0, dep(0))) {
+      // Multiply for all directions at once: [z_bar_1; ...; z_bar_n]*y'
+      // and x'*[z_bar_1, ..., z_bar_n]
+      vector<MX> z_bar(nadj);
+      for (casadi_int d=0; d<nadj; ++d) z_bar[d] = aseed[d][0];
+      const Sparsity& sp_x = dep(1).sparsity();
+      const Sparsity& sp_y = dep(2).sparsity();
+      vector<MX> x_bar = vertsplit(mac(vertcat(z_bar), dep(2).T(),
+                                       MX::zeros(repmat(sp_x, nadj, 1))), sp_x.size1());
+      vector<MX> y_bar = horzsplit(mac(dep(1).T(), horzcat(z_bar),
+                                       MX::zeros(repmat(sp_y, 1, nadj))), sp_y.size2());
+      for (casadi_int d=0; d<nadj; ++d) {
+        asens[d][1] += x_bar[d];
+        asens[d][2] += y_bar[d];
+        asens[d][0] += aseed[d][0];
+      }
+      return;
+    }
     for (casadi_int d=0; d<aseed.size(); ++d) {
       asens[d][1] += mac(aseed[d][0], dep(2).T(), MX::zeros(dep(1).sparsity()));
       asens[d][2] += mac(dep(1).T(), aseed[d][0], MX::zeros(dep(2).sparsity()));
@@ -116,6 +186,15 @@ namespace casadi {
       g << g.copy(g.work(arg[0], nnz()), nnz(), g.work(res[0], nnz())) << '\n';
     }
 
+    // Sparse x, dense y and z, unless small enough to unroll
+    bool unroll = g.unroll>0 && dep(1).nnz()*dep(2).size2() <= g.unroll;
+    if (kernel()==MTIMES_SPARSE_DENSE && !unroll) {
+      g << g.mtimes(g.work(arg[1], dep(1).nnz()), dep(1).sparsity(),
+                    g.work(arg[2], dep(2).nnz()), dep(2).size2(),
+                    g.work(res[0], nnz())) << '\n';
+      return;
+    }
+
     // Perform sparse matrix multiplication
     g << g.mtimes(g.work(arg[1], dep(1).nnz()), dep(1).sparsity(),
                           g.work(arg[2], dep(2).nnz()), dep(2).sparsity(),
@@ -125,24 +204,21 @@ namespace casadi {
   void DenseMultiplication::
   generate(CodeGenerator& g,
            const std::vector<casadi_int>& arg, const std::vector<casadi_int>& res) const {
+    // Small products are unrolled by the sparse kernel
+    if (g.unroll>0 && dep(1).nnz()*dep(2).size2() <= g.unroll) {
+      return Multiplication::generate(g, arg, res);
+    }
+
     // Copy first argument if not inplace
     if (arg[0]!=res[0]) {
       g << g.copy(g.work(arg[0], nnz()), nnz(),
                           g.work(res[0], nnz())) << '\n';
     }
 
-    casadi_int nrow_x = dep(1).size1(), nrow_y = dep(2).size1(), ncol_y = dep(2).size2();
-    g.local("rr", "casadi_real", "*");
-    g.local("ss", "casadi_real", "*");
-    g.local("tt", "casadi_real", "*");
-    g.local("i", "casadi_int");
-    g.local("j", "casadi_int");
-    g.local("k", "casadi_int");
-    g << "for (i=0, rr=" << g.work(res[0], nnz()) <<"; i<" << ncol_y << "; ++i)"
-      << " for (j=0; j<" << nrow_x << "; ++j, ++rr)"
-      << " for (k=0, ss=" << g.work(arg[1], dep(1).nnz()) << "+j, tt="
-      << g.work(arg[2], dep(2).nnz()) << "+i*" << nrow_y << "; k<" << nrow_y << "; ++k)"
-      << " *rr += ss[k*" << nrow_x << "]**tt++;\n";
+    // Dense matrix multiplication
+    g << g.mtimes(g.work(arg[1], dep(1).nnz()), dep(1).size1(), dep(1).size2(),
+                  g.work(arg[2], dep(2).nnz()), dep(2).size2(),
+                  g.work(res[0], nnz())) << '\n';
   }
 
   void Multiplication::serialize_type(SerializingStream& s) const {
@@ -94,6 +94,19 @@ namespace casadi {
     /** \brief Get required length of w field */
     size_t sz_w() const override { return sparsity().size1();}
 
+    /// Kernels for numerical evaluation and code generation
+    enum Kernel {
+      // Sparse, using a dense column of z as work vector
+      MTIMES_SPARSE,
+      // Sparse x, dense y and z, no work vector needed
+      MTIMES_SPARSE_DENSE,
+      // All dense, column-major with unrolling
+      MTIMES_DENSE
+    };
+
+    /// Choose kernel from the sparsity patterns
+    Kernel kernel() const;
+
     /** \brief Serialize specific part of node  */
     void serialize_type(SerializingStream& s) const override;
 
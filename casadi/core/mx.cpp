@@ -36,6 +36,7 @@
 #include "serializing_stream.hpp"
 #include "im.hpp"
 #include "bspline.hpp"
+#include <unordered_map>
 
 // Throw informative error message
 #define CASADI_THROW_ERROR(FNAME, WHAT) \
@@ -1653,6 +1654,116 @@ namespace casadi {
     }
   }
 
+  std::vector<MX> MX::cse(const std::vector<MX>& e) {
+    try {
+      // Sort the expression
+      Function f("tmp", vector<MX>{}, e);
+      auto *ff = f.get<MXFunction>();
+      vector<MX> work(ff->workloc_.size()-1);
+
+      // Nodes encountered so far, bucketed by operation, dependencies and dimensions
+      unordered_map<size_t, vector<MX> > buckets;
+
+      // Return value
+      vector<MX> ret(e.size());
+
+      // Arguments and results of the atomic operations
+      vector<MX> oarg, ores;
+
+      for (auto&& a : ff->algorithm_) {
+        if (a.op==OP_OUTPUT) {
+          casadi_assert(a.data->segment()==0, "Not implemented");
+          ret[a.data->ind()] = work[a.arg.front()];
+          continue;
+        } else if (a.op==OP_PARAMETER) {
+          work[a.res.front()] = a.data;
+          continue;
+        }
+
+        // Arguments of the operation
+        oarg.resize(a.arg.size());
+        bool changed = false;
+        for (casadi_int i=0; i<oarg.size(); ++i) {
+          casadi_int el = a.arg[i];
+          oarg[i] = el<0 ? MX(a.data->dep(i).size()) : work.at(el);
+          if (!is_equal(oarg[i], a.data->dep(i))) changed = true;
+        }
+
+        // Reuse the original node if the dependencies are unchanged
+        ores.resize(a.res.size());
+        if (!changed) {
+          if (a.data->has_output()) {
+            for (casadi_int c=0; c<ores.size(); ++c) ores[c] = a.data.get_output(c);
+          } else {
+            ores.at(0) = a.data;
+          }
+        } else {
+          a.data->eval_mx(oarg, ores);
+        }
+
+        // Node to be merged: the result itself or, for multiple outputs, its parent
+        MX node;
+        for (auto&& r : ores) {
+          if (r.is_null()) continue;
+          if (r.is_output()) {
+            node = r->dep(0);
+            break;
+          } else if (ores.size()==1) {
+            node = r;
+          }
+        }
+
+        if (!node.is_null()) {
+          // Hash on the operation, the dependencies (in any order) and dimensions
+          size_t h = 0, h_dep = 0;
+          hash_combine(h, node->op());
+          for (casadi_int i=0; i<node->n_dep(); ++i) {
+            h_dep += reinterpret_cast<size_t>(node->dep(i).get());
+          }
+          hash_combine(h, h_dep);
+          hash_combine(h, node.size1());
+          hash_combine(h, node.size2());
+          hash_combine(h, node.nnz());
+
+          // Look for an equivalent node, comparing dependencies by identity
+          vector<MX>& b = buckets[h];
+          MX match;
+          for (auto&& n : b) {
+            if (MXNode::is_equal(n.get(), node.get(), 1)) {
+              match = n;
+              break;
+            }
+          }
+          if (match.is_null()) {
+            b.push_back(node);
+          } else if (match.get()!=node.get()) {
+            // Replace with the existing node
+            if (ores.size()==1 && !ores[0].is_output()) {
+              ores[0] = match;
+            } else {
+              for (casadi_int c=0; c<ores.size(); ++c) {
+                if (!ores[c].is_null()) ores[c] = match.get_output(c);
+              }
+            }
+          }
+        }
+
+        // Get the result
+        for (casadi_int i=0; i<ores.size(); ++i) {
+          casadi_int el = a.res[i];
+          if (el>=0) work.at(el) = ores[i];
+        }
+      }
+      return ret;
+    } catch (std::exception& e) {
+      CASADI_THROW_ERROR("cse", e.what());
+    }
+  }
+
+  MX MX::cse(const MX& e) {
+    return cse(std::vector<MX>{e}).front();
+  }
+
   MX MX::jacobian(const MX &f, const MX &x, const Dict& opts) {
     try {
       Dict h_opts;
@@ -61,7 +61,10 @@ namespace casadi {
         "Default input values"}},
       {"live_variables",
        {OT_BOOL,
-        "Reuse variables in the work vector"}}
+        "Reuse variables in the work vector"}},
+      {"cse",
+       {OT_BOOL,
+        "Merge structurally identical subexpressions before sorting the graph"}}
      }
   };
 
@@ -103,6 +106,7 @@ namespace casadi {
 
     // Default (temporary) options
     live_variables_ = true;
+    bool cse = false;
 
     // Read options
     for (auto&& op : opts) {
@@ -110,9 +114,14 @@ namespace casadi {
         default_in_ = op.second;
       } else if (op.first=="live_variables") {
         live_variables_ = op.second;
+      } else if (op.first=="cse") {
+        cse = op.second;
       }
     }
 
+    // Common subexpression elimination
+    if (cse) out_ = MX::cse(out_);
+
     // Check/set default inputs
     if (default_in_.empty()) {
       default_in_.resize(n_in_, 0);
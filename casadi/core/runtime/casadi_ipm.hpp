@@ -0,0 +1,112 @@
+// NOLINT(legal/copyright)
+
+// Kernels shared by the primal-dual interior point QP solvers. The slacks and
+// multipliers of the lower and upper bounds of n variables or constraints are
+// stored consecutively, v = [sl; su; laml; lamu], and so are their steps dv
+// and the complementarity residuals rc = [rcl; rcu]. Slack v[j] is paired with
+// multiplier v[2*n+j]; bounds without slacks have zero slack and multiplier.
+
+// C-REPLACE "fmin" "casadi_fmin"
+// C-REPLACE "fmax" "casadi_fmax"
+// SYMBOL "ipm_reset"
+// Interior slacks and unit multipliers for the finite bounds lbz <= z <= ubz,
+// no slacks for equality constraints if eq is nonzero
+template<typename T1>
+void casadi_ipm_reset(casadi_int n, const T1* z, const T1* lbz, const T1* ubz, T1* v,
+                      T1 inf, casadi_int eq) {
+  // Local variables
+  casadi_int i;
+  T1 *sl, *su, *laml, *lamu;
+  sl = v;
+  su = v + n;
+  laml = v + 2*n;
+  lamu = v + 3*n;
+  for (i=0; i<n; ++i) {
+    sl[i] = laml[i] = su[i] = lamu[i] = 0;
+    if (eq && lbz[i] == ubz[i]) continue;
+    if (lbz[i] > -inf) {
+      sl[i] = fmax(z[i] - lbz[i], 1.);
+      laml[i] = 1.;
+    }
+    if (ubz[i] < inf) {
+      su[i] = fmax(ubz[i] - z[i], 1.);
+      lamu[i] = 1.;
+    }
+  }
+}
+
+// SYMBOL "ipm_dual"
+// Multipliers of fixed variables and strongly active bounds from stationarity,
+// avoiding the cancellation in lamu-laml when the slacks are tiny. On entry,
+// r is the gradient of the Lagrangian; returns the dual error
+template<typename T1>
+T1 casadi_ipm_dual(casadi_int n, const T1* lbz, const T1* ubz, const T1* sl, const T1* su,
+                   const T1* laml, const T1* lamu, T1* lam, T1* r, T1 inf) {
+  // Local variables
+  casadi_int i;
+  T1 s;
+  for (i=0; i<n; ++i) {
+    s = lam[i] - r[i];
+    if (lbz[i] == ubz[i]
+        || (lbz[i] > -inf && sl[i] < laml[i] && s <= 0)
+        || (ubz[i] < inf && su[i] < lamu[i] && s >= 0)) {
+      lam[i] = s;
+      r[i] = 0;
+    }
+  }
+  return casadi_norm_inf(n, r);
+}
+
+// SYMBOL "ipm_max_step"
+// Largest step in [0, 1] keeping slacks and multipliers nonnegative
+template<typename T1>
+T1 casadi_ipm_max_step(casadi_int n, const T1* v, const T1* dv) {
+  // Local variables
+  casadi_int i;
+  T1 alpha;
+  alpha = 1.;
+  for (i=0; i<4*n; ++i) {
+    if (dv[i] < 0) alpha = fmin(alpha, -v[i]/dv[i]);
+  }
+  return alpha;
+}
+
+// SYMBOL "ipm_predictor"
+// Complementarity residuals of the affine scaling (predictor) step
+template<typename T1>
+void casadi_ipm_predictor(casadi_int n, const T1* v, T1* rc) {
+  // Local variables
+  casadi_int i;
+  for (i=0; i<2*n; ++i) rc[i] = v[i]*v[2*n+i];
+}
+
+// SYMBOL "ipm_corrector"
+// Mehrotra centering parameter from the affine scaling step dv, complementarity
+// residuals of the corrector step. Returns the centering parameter
+template<typename T1>
+T1 casadi_ipm_corrector(casadi_int n, const T1* v, const T1* dv, T1* rc, T1 mu) {
+  // Local variables
+  casadi_int i, n_ineq;
+  T1 alpha, mu_aff, sigma;
+  // Complementarity after the affine scaling step
+  alpha = casadi_ipm_max_step(n, v, dv);
+  mu_aff = 0;
+  n_ineq = 0;
+  for (i=0; i<2*n; ++i) {
+    if (v[2*n+i] > 0) {
+      mu_aff += (v[i] + alpha*dv[i])*(v[2*n+i] + alpha*dv[2*n+i]);
+      n_ineq++;
+    }
+  }
+  // Centering parameter
+  if (n_ineq > 0 && mu > 0) {
+    mu_aff /= n_ineq;
+    sigma = mu_aff/mu;
+    sigma = sigma*sigma*sigma;
+  } else {
+    sigma = 0;
+  }
+  // Second order and centering terms
+  for (i=0; i<2*n; ++i) rc[i] += dv[i]*dv[2*n+i] - sigma*mu;
+  return sigma;
+}
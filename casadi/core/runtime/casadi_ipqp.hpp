@@ -0,0 +1,402 @@
+// NOLINT(legal/copyright)
+
+// C-REPLACE "fmin" "casadi_fmin"
+// C-REPLACE "fmax" "casadi_fmax"
+// C-REPLACE "std::numeric_limits<T1>::infinity()" "casadi_inf"
+// SYMBOL "ipqp_prob"
+template<typename T1>
+struct casadi_ipqp_prob {
+  // Sparsity patterns
+  const casadi_int *sp_a, *sp_h, *sp_at, *sp_kkt;
+  // Symbolic LDL^T factorization of the KKT system
+  const casadi_int *sp_lt, *perm;
+  // Dimensions
+  casadi_int nx, na, nz;
+  // Infinity
+  T1 inf;
+  // Maximum number of iterations
+  casadi_int max_iter;
+  // Tolerance for primal and dual error and complementarity
+  T1 tol;
+  // Regularization of the KKT system
+  T1 reg;
+};
+// C-REPLACE "casadi_ipqp_prob<T1>" "struct casadi_ipqp_prob"
+
+// SYMBOL "ipqp_setup"
+template<typename T1>
+void casadi_ipqp_setup(casadi_ipqp_prob<T1>* p) {
+  p->na = p->sp_a[0];
+  p->nx = p->sp_a[1];
+  p->nz = p->nx + p->na;
+  p->inf = std::numeric_limits<T1>::infinity();
+  p->max_iter = 100;
+  p->tol = 1e-8;
+  p->reg = 1e-9;
+}
+
+// SYMBOL "ipqp_work"
+template<typename T1>
+void casadi_ipqp_work(const casadi_ipqp_prob<T1>* p, casadi_int* sz_iw, casadi_int* sz_w) {
+  // Local variables
+  casadi_int nnz_a, nnz_kkt, nnz_lt;
+  // Get matrix number of nonzeros
+  nnz_a = p->sp_a[2+p->sp_a[1]];
+  nnz_kkt = p->sp_kkt[2+p->sp_kkt[1]];
+  nnz_lt = p->sp_lt[2+p->sp_lt[1]];
+  // Reset sz_w, sz_iw
+  *sz_w = *sz_iw = 0;
+  // Temporary work vectors
+  *sz_w = casadi_max(*sz_w, p->nz); // KKT columns, casadi_ldl, casadi_ldl_solve
+  *sz_iw = casadi_max(*sz_iw, p->na); // casadi_trans
+  // Persistent work vectors
+  *sz_w += nnz_kkt; // kkt
+  *sz_w += nnz_lt; // L factor
+  *sz_w += p->nz; // D factor
+  *sz_w += nnz_a; // trans(a)
+  *sz_w += p->nz; // z=[x, a*x]
+  *sz_w += p->nz; // lbz
+  *sz_w += p->nz; // ubz
+  *sz_w += p->nz; // lam
+  *sz_w += 4*p->nz; // sl, su, laml, lamu
+  *sz_w += 4*p->nz; // dsl, dsu, dlaml, dlamu
+  *sz_w += 2*p->nz; // rcl, rcu
+  *sz_w += p->nz; // dz
+  *sz_w += p->nz; // dlam
+  *sz_w += p->nz; // sig
+  *sz_w += p->nz; // t
+  *sz_w += p->nz; // rhs
+  *sz_w += p->nx; // rd
+}
+
+// SYMBOL "ipqp_flag_t"
+typedef enum {
+  IPQP_SUCCESS,
+  IPQP_MAX_ITER,
+  IPQP_NOT_CONVEX,
+  IPQP_INFEASIBLE_BOUNDS
+} casadi_ipqp_flag_t;
+
+// SYMBOL "ipqp_data"
+template<typename T1>
+struct casadi_ipqp_data {
+  // Problem structure
+  const casadi_ipqp_prob<T1>* prob;
+  // Solver status
+  casadi_ipqp_flag_t status;
+  // Cost
+  T1 f;
+  // QP data
+  const T1 *nz_a, *nz_h, *g;
+  // Vectors
+  T1 *z, *lbz, *ubz, *lam, *w;
+  casadi_int *iw;
+  // Slacks and multipliers of the lower and upper bounds, steps (consecutive)
+  T1 *sl, *su, *laml, *lamu, *dsl, *dsu, *dlaml, *dlamu;
+  // Complementarity residuals, primal and dual step, barrier weights
+  T1 *rcl, *rcu, *dz, *dlam, *sig, *t;
+  // Gradient of the Lagrangian, right-hand side of the KKT system
+  T1 *rd, *rhs;
+  // Numeric LDL^T factorization
+  T1 *nz_at, *nz_kkt, *nz_lt, *nz_d;
+  // Primal and dual error, complementarity
+  T1 pr, du, mu;
+  // Centering parameter, step size
+  T1 sigma, alpha;
+  // Iteration
+  casadi_int iter;
+};
+// C-REPLACE "casadi_ipqp_data<T1>" "struct casadi_ipqp_data"
+
+// SYMBOL "ipqp_init"
+template<typename T1>
+void casadi_ipqp_init(casadi_ipqp_data<T1>* d, casadi_int** iw, T1** w) {
+  // Local variables
+  casadi_int nnz_a, nnz_kkt, nnz_lt;
+  const casadi_ipqp_prob<T1>* p = d->prob;
+  // Get matrix number of nonzeros
+  nnz_a = p->sp_a[2+p->sp_a[1]];
+  nnz_kkt = p->sp_kkt[2+p->sp_kkt[1]];
+  nnz_lt = p->sp_lt[2+p->sp_lt[1]];
+  d->nz_kkt = *w; *w += nnz_kkt;
+  d->nz_lt = *w; *w += nnz_lt;
+  d->nz_d = *w; *w += p->nz;
+  d->nz_at = *w; *w += nnz_a;
+  d->z = *w; *w += p->nz;
+  d->lbz = *w; *w += p->nz;
+  d->ubz = *w; *w += p->nz;
+  d->lam = *w; *w += p->nz;
+  d->sl = *w; *w += p->nz;
+  d->su = *w; *w += p->nz;
+  d->laml = *w; *w += p->nz;
+  d->lamu = *w; *w += p->nz;
+  d->dsl = *w; *w += p->nz;
+  d->dsu = *w; *w += p->nz;
+  d->dlaml = *w; *w += p->nz;
+  d->dlamu = *w; *w += p->nz;
+  d->rcl = *w; *w += p->nz;
+  d->rcu = *w; *w += p->nz;
+  d->dz = *w; *w += p->nz;
+  d->dlam = *w; *w += p->nz;
+  d->sig = *w; *w += p->nz;
+  d->t = *w; *w += p->nz;
+  d->rhs = *w; *w += p->nz;
+  d->rd = *w; *w += p->nx;
+  d->w = *w;
+  d->iw = *iw;
+}
+
+// SYMBOL "ipqp_reset"
+template<typename T1>
+int casadi_ipqp_reset(casadi_ipqp_data<T1>* d) {
+  // Local variables
+  casadi_int i;
+  const casadi_ipqp_prob<T1>* p = d->prob;
+  // Transpose A
+  casadi_trans(d->nz_a, p->sp_a, d->nz_at, p->sp_at, d->iw);
+  // Row values of the initial guess
+  casadi_clear(d->z+p->nx, p->na);
+  casadi_mv(d->nz_a, p->sp_a, d->z, d->z+p->nx, 0);
+  // Consistent bounds
+  for (i=0; i<p->nz; ++i) {
+    if (d->lbz[i] > d->ubz[i]) {
+      d->status = IPQP_INFEASIBLE_BOUNDS;
+      return 1;
+    }
+  }
+  // Interior slacks and multipliers, equality constraints have no slacks
+  casadi_clear(d->lam, p->nz);
+  casadi_ipm_reset(p->nz, d->z, d->lbz, d->ubz, d->sl, p->inf, 1);
+  // Reset iteration counter
+  d->iter = 0;
+  d->alpha = 0;
+  d->sigma = 0;
+  return 0;
+}
+
+// SYMBOL "ipqp_prepare"
+template<typename T1>
+int casadi_ipqp_prepare(casadi_ipqp_data<T1>* d) {
+  // Local variables
+  casadi_int i, n_ineq;
+  const casadi_ipqp_prob<T1>* p = d->prob;
+  // Row values
+  casadi_clear(d->z+p->nx, p->na);
+  casadi_mv(d->nz_a, p->sp_a, d->z, d->z+p->nx, 0);
+  // Cost
+  d->f = casadi_bilin(d->nz_h, p->sp_h, d->z, d->z)/2. + casadi_dot(p->nx, d->z, d->g);
+  // Multipliers of the simple bounds and inequality constraints
+  for (i=0; i<p->nz; ++i) {
+    if (i < p->nx || d->lbz[i] != d->ubz[i]) d->lam[i] = d->lamu[i] - d->laml[i];
+  }
+  // Gradient of the Lagrangian
+  casadi_copy(d->g, p->nx, d->rd);
+  casadi_mv(d->nz_h, p->sp_h, d->z, d->rd, 0);
+  casadi_axpy(p->nx, 1., d->lam, d->rd);
+  casadi_mv(d->nz_a, p->sp_a, d->lam+p->nx, d->rd, 1);
+  // Multipliers of fixed variables and strongly active bounds, dual error
+  casadi_copy(d->rd, p->nx, d->w);
+  d->du = casadi_ipm_dual(p->nx, d->lbz, d->ubz, d->sl, d->su, d->laml, d->lamu,
+                          d->lam, d->w, p->inf);
+  // Primal error and complementarity
+  d->pr = 0;
+  d->mu = 0;
+  n_ineq = 0;
+  for (i=0; i<p->nz; ++i) {
+    if (d->lbz[i] == d->ubz[i]) {
+      d->pr = fmax(d->pr, fabs(d->z[i] - d->lbz[i]));
+      continue;
+    }
+    if (d->lbz[i] > -p->inf) {
+      d->pr = fmax(d->pr, fabs(d->z[i] - d->lbz[i] - d->sl[i]));
+      d->mu += d->sl[i]*d->laml[i];
+      n_ineq++;
+    }
+    if (d->ubz[i] < p->inf) {
+      d->pr = fmax(d->pr, fabs(d->ubz[i] - d->z[i] - d->su[i]));
+      d->mu += d->su[i]*d->lamu[i];
+      n_ineq++;
+    }
+  }
+  if (n_ineq > 0) d->mu /= n_ineq;
+  // Termination
+  if (d->pr <= p->tol && d->du <= p->tol && d->mu <= p->tol) {
+    d->status = IPQP_SUCCESS;
+    return 1;
+  } else if (d->iter >= p->max_iter) {
+    d->status = IPQP_MAX_ITER;
+    return 1;
+  }
+  return 0;
+}
+
+// SYMBOL "ipqp_kkt"
+// Assemble and factorize the regularized KKT system
+//   [H + Sigma_x + reg*I, A'; A, -inv(Sigma_a)]
+// with fixed variables decoupled and inactive rows with only infinite bounds
+template<typename T1>
+int casadi_ipqp_kkt(casadi_ipqp_data<T1>* d) {
+  // Local variables
+  casadi_int i, j, k;
+  const casadi_int *h_colind, *h_row, *a_colind, *a_row, *at_colind, *at_row,
+                   *kkt_colind, *kkt_row;
+  const casadi_ipqp_prob<T1>* p = d->prob;
+  // Extract sparsities
+  a_row = (a_colind = p->sp_a+2) + p->nx + 1;
+  at_row = (at_colind = p->sp_at+2) + p->na + 1;
+  h_row = (h_colind = p->sp_h+2) + p->nx + 1;
+  kkt_row = (kkt_colind = p->sp_kkt+2) + p->nz + 1;
+  // Barrier weights
+  for (i=0; i<p->nz; ++i) {
+    d->sig[i] = 0;
+    if (d->lbz[i] == d->ubz[i]) continue;
+    if (d->lbz[i] > -p->inf) d->sig[i] += d->laml[i]/d->sl[i];
+    if (d->ubz[i] < p->inf) d->sig[i] += d->lamu[i]/d->su[i];
+  }
+  // Reset w to zero
+  casadi_clear(d->w, p->nz);
+  // Loop over columns of the KKT system
+  for (i=0; i<p->nz; ++i) {
+    // Copy column of KKT to w
+    if (i<p->nx) {
+      if (d->lbz[i] == d->ubz[i]) {
+        d->w[i] = 1.;
+      } else {
+        for (k=h_colind[i]; k<h_colind[i+1]; ++k) {
+          j = h_row[k];
+          if (d->lbz[j] != d->ubz[j]) d->w[j] = d->nz_h[k];
+        }
+        for (k=a_colind[i]; k<a_colind[i+1]; ++k) {
+          j = p->nx + a_row[k];
+          if (d->lbz[j] == d->ubz[j] || d->sig[j] > 0) d->w[j] = d->nz_a[k];
+        }
+        d->w[i] += d->sig[i] + p->reg;
+      }
+    } else {
+      if (d->lbz[i] == d->ubz[i]) {
+        d->w[i] = -p->reg;
+      } else if (d->sig[i] > 0) {
+        d->w[i] = -1./d->sig[i];
+      } else {
+        d->w[i] = -1.;
+      }
+      if (d->lbz[i] == d->ubz[i] || d->sig[i] > 0) {
+        for (k=at_colind[i-p->nx]; k<at_colind[i-p->nx+1]; ++k) {
+          j = at_row[k];
+          if (d->lbz[j] != d->ubz[j]) d->w[j] = d->nz_at[k];
+        }
+      }
+    }
+    // Copy column to KKT, zero out w
+    for (k=kkt_colind[i]; k<kkt_colind[i+1]; ++k) {
+      d->nz_kkt[k] = d->w[kkt_row[k]];
+      d->w[kkt_row[k]] = 0;
+    }
+  }
+  // Factorize
+  casadi_ldl(p->sp_kkt, d->nz_kkt, p->sp_lt, d->nz_lt, d->nz_d, p->perm, d->w);
+  // Quasidefinite: positive pivots for the variables, negative for the constraints
+  for (i=0; i<p->nz; ++i) {
+    if (p->perm[i] < p->nx ? !(d->nz_d[i] > 0) : !(d->nz_d[i] < 0)) return 1;
+  }
+  return 0;
+}
+
+// SYMBOL "ipqp_solve"
+// Newton step for given complementarity residuals rcl, rcu
+template<typename T1>
+void casadi_ipqp_solve(casadi_ipqp_data<T1>* d) {
+  // Local variables
+  casadi_int i, j, k;
+  T1 rpl, rpu, dx;
+  const casadi_int *h_colind, *h_row, *a_colind, *a_row;
+  const casadi_ipqp_prob<T1>* p = d->prob;
+  // Extract sparsities
+  a_row = (a_colind = p->sp_a+2) + p->nx + 1;
+  h_row = (h_colind = p->sp_h+2) + p->nx + 1;
+  // Right-hand side after eliminating slacks and multipliers
+  for (i=0; i<p->nz; ++i) {
+    d->t[i] = 0;
+    if (d->lbz[i] == d->ubz[i]) continue;
+    if (d->lbz[i] > -p->inf) {
+      rpl = d->z[i] - d->lbz[i] - d->sl[i];
+      d->t[i] -= (d->rcl[i] + d->laml[i]*rpl)/d->sl[i];
+    }
+    if (d->ubz[i] < p->inf) {
+      rpu = d->ubz[i] - d->z[i] - d->su[i];
+      d->t[i] += (d->rcu[i] + d->lamu[i]*rpu)/d->su[i];
+    }
+  }
+  for (i=0; i<p->nz; ++i) {
+    if (d->lbz[i] == d->ubz[i]) {
+      d->rhs[i] = d->lbz[i] - d->z[i];
+    } else if (i<p->nx) {
+      d->rhs[i] = d->t[i] - d->rd[i];
+    } else if (d->sig[i] > 0) {
+      d->rhs[i] = d->t[i]/d->sig[i];
+    } else {
+      d->rhs[i] = 0;
+    }
+  }
+  // Move the known steps of fixed variables to the right-hand side
+  for (i=0; i<p->nx; ++i) {
+    if (d->lbz[i] != d->ubz[i]) continue;
+    dx = d->rhs[i];
+    for (k=h_colind[i]; k<h_colind[i+1]; ++k) {
+      if (d->lbz[h_row[k]] != d->ubz[h_row[k]]) d->rhs[h_row[k]] -= d->nz_h[k]*dx;
+    }
+    for (k=a_colind[i]; k<a_colind[i+1]; ++k) {
+      j = p->nx + a_row[k];
+      if (d->lbz[j] == d->ubz[j] || d->sig[j] > 0) d->rhs[j] -= d->nz_a[k]*dx;
+    }
+  }
+  // Solve the KKT system
+  casadi_ldl_solve(d->rhs, 1, p->sp_lt, d->nz_lt, d->nz_d, p->perm, d->w);
+  // Primal and dual step
+  casadi_copy(d->rhs, p->nx, d->dz);
+  casadi_clear(d->dz+p->nx, p->na);
+  casadi_mv(d->nz_a, p->sp_a, d->dz, d->dz+p->nx, 0);
+  casadi_clear(d->dlam, p->nx);
+  casadi_copy(d->rhs+p->nx, p->na, d->dlam+p->nx);
+  // Step in the slacks and multipliers
+  for (i=0; i<p->nz; ++i) {
+    d->dsl[i] = d->dlaml[i] = d->dsu[i] = d->dlamu[i] = 0;
+    if (d->lbz[i] == d->ubz[i]) continue;
+    if (d->lbz[i] > -p->inf) {
+      d->dsl[i] = d->z[i] + d->dz[i] - d->lbz[i] - d->sl[i];
+      d->dlaml[i] = -(d->rcl[i] + d->laml[i]*d->dsl[i])/d->sl[i];
+    }
+    if (d->ubz[i] < p->inf) {
+      d->dsu[i] = d->ubz[i] - d->z[i] - d->dz[i] - d->su[i];
+      d->dlamu[i] = -(d->rcu[i] + d->lamu[i]*d->dsu[i])/d->su[i];
+    }
+  }
+}
+
+// SYMBOL "ipqp_iterate"
+// Mehrotra predictor-corrector step
+template<typename T1>
+int casadi_ipqp_iterate(casadi_ipqp_data<T1>* d) {
+  // Local variables
+  const casadi_ipqp_prob<T1>* p = d->prob;
+  // Start a new iteration
+  d->iter++;
+  // Factorize the KKT system
+  if (casadi_ipqp_kkt(d)) {
+    d->status = IPQP_NOT_CONVEX;
+    return 1;
+  }
+  // Affine scaling (predictor) step
+  casadi_ipm_predictor(p->nz, d->sl, d->rcl);
+  casadi_ipqp_solve(d);
+  // Centering parameter, corrector step
+  d->sigma = casadi_ipm_corrector(p->nz, d->sl, d->dsl, d->rcl, d->mu);
+  casadi_ipqp_solve(d);
+  // Step size, stay in the interior
+  d->alpha = fmin(1., 0.995*casadi_ipm_max_step(p->nz, d->sl, d->dsl));
+  // Take step
+  casadi_axpy(p->nx, d->alpha, d->dz, d->z);
+  casadi_axpy(p->nz, d->alpha, d->dlam, d->lam);
+  casadi_axpy(4*p->nz, d->alpha, d->dsl, d->sl);
+  return 0;
+}
@@ -0,0 +1,64 @@
+// NOLINT(legal/copyright)
+// SYMBOL "lbfgs"
+// Limited-memory BFGS approximation with dense diagonal blocks
+// The approximation is rebuilt from a scaled identity using the np most
+// recent pairs (s, y), stored column-wise in ring buffers with m columns,
+// the most recent pair being in column last. Updates are damped (Powell)
+// and made separately for each diagonal block of sp_h.
+template<typename T1>
+void casadi_lbfgs(const casadi_int* sp_h, T1* h, const T1* s, const T1* y,
+                  casadi_int m, casadi_int np, casadi_int last, T1* w) {
+  // Local variables
+  casadi_int nx, c, nb, i, j, k, l;
+  const casadi_int* colind;
+  const T1 *sk, *yk;
+  T1 *qk, *rk, sy, sqk, omega, delta;
+  // Dimension
+  nx = sp_h[1];
+  colind = sp_h + 2;
+  // Work vectors
+  qk = w; w += nx;
+  rk = w; w += nx;
+  // Loop over diagonal blocks
+  for (c=0; c<nx; c+=nb) {
+    nb = colind[c+1] - colind[c];
+    // Initial scaling from the most recent pair with positive curvature
+    delta = 1;
+    for (l=0; l<np; ++l) {
+      k = (last - l + m) % m;
+      sk = s + k*nx + c;
+      yk = y + k*nx + c;
+      sy = casadi_dot(nb, sk, yk);
+      if (sy > 0) {
+        delta = casadi_dot(nb, yk, yk) / sy;
+        break;
+      }
+    }
+    casadi_clear(h, nb*nb);
+    for (i=0; i<nb; ++i) h[i+i*nb] = delta;
+    // Updates from the oldest to the most recent pair
+    for (l=np-1; l>=0; --l) {
+      k = (last - l + m) % m;
+      sk = s + k*nx + c;
+      yk = y + k*nx + c;
+      // qk = H*sk
+      for (i=0; i<nb; ++i) qk[i] = casadi_dot(nb, h+i*nb, sk);
+      sqk = casadi_dot(nb, sk, qk);
+      // Skip if no step in this block
+      if (sqk <= 0) continue;
+      // Damping: rk = omega*yk + (1-omega)*qk
+      sy = casadi_dot(nb, sk, yk);
+      omega = sy < 0.2*sqk ? 0.8*sqk/(sqk - sy) : 1;
+      casadi_copy(yk, nb, rk);
+      casadi_scal(nb, omega, rk);
+      casadi_axpy(nb, 1 - omega, qk, rk);
+      sy = casadi_dot(nb, sk, rk);
+      // Update H
+      for (j=0; j<nb; ++j) {
+        for (i=0; i<nb; ++i) h[i+j*nb] += rk[i]*rk[j]/sy - qk[i]*qk[j]/sqk;
+      }
+    }
+    // Next block
+    h += nb*nb;
+  }
+}
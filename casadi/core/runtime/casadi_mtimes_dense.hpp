@@ -0,0 +1,39 @@
+// NOLINT(legal/copyright)
+// SYMBOL "mtimes_dense"
+template<typename T1>
+void casadi_mtimes_dense(const T1* x, casadi_int nrow_x, casadi_int ncol_x,
+    const T1* y, casadi_int ncol_y, T1* z) {
+  casadi_int i, j, k;
+  const T1 *x0, *x1, *x2, *x3;
+  T1 y0, y1, y2, y3, t;
+  // Loop over the columns of y and z, all stored densely
+  for (j=0; j<ncol_y; ++j) {
+    // Four columns of x at a time, the column of z is traversed contiguously
+    for (k=0; k+4<=ncol_x; k+=4) {
+      x0 = x + k*nrow_x;
+      x1 = x0 + nrow_x;
+      x2 = x1 + nrow_x;
+      x3 = x2 + nrow_x;
+      y0 = y[k];
+      y1 = y[k+1];
+      y2 = y[k+2];
+      y3 = y[k+3];
+      for (i=0; i<nrow_x; ++i) {
+        t = z[i];
+        t += x0[i]*y0;
+        t += x1[i]*y1;
+        t += x2[i]*y2;
+        t += x3[i]*y3;
+        z[i] = t;
+      }
+    }
+    // Remaining columns of x
+    for (; k<ncol_x; ++k) {
+      x0 = x + k*nrow_x;
+      y0 = y[k];
+      for (i=0; i<nrow_x; ++i) z[i] += x0[i]*y0;
+    }
+    y += ncol_x;
+    z += nrow_x;
+  }
+}
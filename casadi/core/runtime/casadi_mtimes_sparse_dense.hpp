@@ -0,0 +1,24 @@
+// NOLINT(legal/copyright)
+// SYMBOL "mtimes_sparse_dense"
+template<typename T1>
+void casadi_mtimes_sparse_dense(const T1* x, const casadi_int* sp_x,
+    const T1* y, casadi_int ncol_y, T1* z) {
+  casadi_int nrow_x, ncol_x, j, k, kk;
+  const casadi_int *colind_x, *row_x;
+  T1 yk;
+  nrow_x = sp_x[0];
+  ncol_x = sp_x[1];
+  colind_x = sp_x+2; row_x = sp_x + 2 + ncol_x+1;
+  // Loop over the columns of y and z, both stored densely
+  for (j=0; j<ncol_y; ++j) {
+    // Scatter each column of x, scaled, into the column of z
+    for (k=0; k<ncol_x; ++k) {
+      yk = y[k];
+      for (kk=colind_x[k]; kk<colind_x[k+1]; ++kk) {
+        z[row_x[kk]] += x[kk]*yk;
+      }
+    }
+    y += ncol_x;
+    z += nrow_x;
+  }
+}
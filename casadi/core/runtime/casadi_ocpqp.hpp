@@ -0,0 +1,552 @@
+// NOLINT(legal/copyright)
+
+// C-REPLACE "fmin" "casadi_fmin"
+// C-REPLACE "fmax" "casadi_fmax"
+// C-REPLACE "std::numeric_limits<T1>::infinity()" "casadi_inf"
+// SYMBOL "ocpqp_prob"
+template<typename T1>
+struct casadi_ocpqp_prob {
+  // Sparsity patterns
+  const casadi_int *sp_a, *sp_h;
+  // Dimensions
+  casadi_int nx, na, nz;
+  // Horizon
+  casadi_int N;
+  // Number of states, controls and path constraints for each stage, length N+1
+  const casadi_int *nxs, *nus, *ngs;
+  // Infinity
+  T1 inf;
+  // Maximum number of iterations
+  casadi_int max_iter;
+  // Tolerance for primal and dual error and complementarity
+  T1 tol;
+};
+// C-REPLACE "casadi_ocpqp_prob<T1>" "struct casadi_ocpqp_prob"
+
+// SYMBOL "ocpqp_setup"
+template<typename T1>
+void casadi_ocpqp_setup(casadi_ocpqp_prob<T1>* p) {
+  p->na = p->sp_a[0];
+  p->nx = p->sp_a[1];
+  p->nz = p->nx + p->na;
+  p->inf = std::numeric_limits<T1>::infinity();
+  p->max_iter = 100;
+  p->tol = 1e-8;
+}
+
+// SYMBOL "ocpqp_work"
+template<typename T1>
+void casadi_ocpqp_work(const casadi_ocpqp_prob<T1>* p, casadi_int* sz_iw, casadi_int* sz_w) {
+  // Local variables
+  casadi_int k, n, nx1, sz_tmp;
+  // Reset sz_w, sz_iw
+  *sz_w = *sz_iw = 0;
+  // Temporary work vectors
+  sz_tmp = p->nz;
+  for (k=0; k<p->N; ++k) {
+    n = p->nxs[k] + p->nus[k];
+    nx1 = p->nxs[k+1];
+    sz_tmp = casadi_max(sz_tmp, nx1*n); // P*G
+  }
+  *sz_w += sz_tmp;
+  // Persistent work vectors
+  *sz_w += p->nz; // z=[x, a*x]
+  *sz_w += p->nz; // lbz
+  *sz_w += p->nz; // ubz
+  *sz_w += p->nz; // lam
+  *sz_w += 4*p->nz; // sl, su, laml, lamu
+  *sz_w += 4*p->nz; // dsl, dsu, dlaml, dlamu
+  *sz_w += 2*p->nz; // rcl, rcu
+  *sz_w += p->nz; // dz
+  *sz_w += p->nz; // sig, t
+  *sz_w += p->nx; // rd
+  *sz_w += p->nx; // q
+  for (k=0; k<=p->N; ++k) {
+    n = p->nxs[k] + p->nus[k];
+    nx1 = k<p->N ? p->nxs[k+1] : 0;
+    *sz_w += n*n; // m, factorized in-place
+    *sz_w += nx1*n; // gk
+    *sz_w += 3*nx1; // e, b, c
+    *sz_w += p->ngs[k]*n; // cd
+    *sz_w += n; // y
+  }
+  // Offsets for each stage
+  *sz_iw += 7*(p->N+1);
+}
+
+// SYMBOL "ocpqp_flag_t"
+typedef enum {
+  OCPQP_SUCCESS,
+  OCPQP_MAX_ITER,
+  OCPQP_NOT_CONVEX,
+  OCPQP_BAD_DYNAMICS
+} casadi_ocpqp_flag_t;
+
+// SYMBOL "ocpqp_data"
+template<typename T1>
+struct casadi_ocpqp_data {
+  // Problem structure
+  const casadi_ocpqp_prob<T1>* prob;
+  // Solver status
+  casadi_ocpqp_flag_t status;
+  // Cost
+  T1 f;
+  // QP data
+  const T1 *nz_a, *nz_h, *g;
+  // Vectors
+  T1 *z, *lbz, *ubz, *lam, *w;
+  // Slacks and multipliers of the lower and upper bounds, steps (consecutive)
+  T1 *sl, *su, *laml, *lamu, *dsl, *dsu, *dlaml, *dlamu;
+  // Complementarity residuals, primal step, barrier weights
+  T1 *rcl, *rcu, *dz, *sig, *t;
+  // Gradient of the Lagrangian, right-hand side of the reduced system
+  T1 *rd, *q;
+  // Stage-wise dense blocks: KKT blocks with Riccati factorization,
+  // dynamics, dynamics diagonal, dynamics constant, dynamics residual,
+  // path constraints and solution
+  T1 *m, *gk, *e, *b, *c, *cd, *y;
+  // Stage offsets in z, a, m, gk, e, cd, y
+  casadi_int *oz, *oa, *om, *og, *oe, *ocd, *oy;
+  // Primal and dual error, complementarity
+  T1 pr, du, mu;
+  // Centering parameter, step size
+  T1 sigma, alpha;
+  // Iteration
+  casadi_int iter;
+};
+// C-REPLACE "casadi_ocpqp_data<T1>" "struct casadi_ocpqp_data"
+
+// SYMBOL "ocpqp_init"
+template<typename T1>
+void casadi_ocpqp_init(casadi_ocpqp_data<T1>* d, casadi_int** iw, T1** w) {
+  // Local variables
+  casadi_int k, n, nx1;
+  const casadi_ocpqp_prob<T1>* p = d->prob;
+  d->z = *w; *w += p->nz;
+  d->lbz = *w; *w += p->nz;
+  d->ubz = *w; *w += p->nz;
+  d->lam = *w; *w += p->nz;
+  d->sl = *w; *w += p->nz;
+  d->su = *w; *w += p->nz;
+  d->laml = *w; *w += p->nz;
+  d->lamu = *w; *w += p->nz;
+  d->dsl = *w; *w += p->nz;
+  d->dsu = *w; *w += p->nz;
+  d->dlaml = *w; *w += p->nz;
+  d->dlamu = *w; *w += p->nz;
+  d->rcl = *w; *w += p->nz;
+  d->rcu = *w; *w += p->nz;
+  d->dz = *w; *w += p->nz;
+  d->sig = d->t = *w; *w += p->nz;
+  d->rd = *w; *w += p->nx;
+  d->q = *w; *w += p->nx;
+  d->oz = *iw; *iw += p->N+1;
+  d->oa = *iw; *iw += p->N+1;
+  d->om = *iw; *iw += p->N+1;
+  d->og = *iw; *iw += p->N+1;
+  d->oe = *iw; *iw += p->N+1;
+  d->ocd = *iw; *iw += p->N+1;
+  d->oy = *iw; *iw += p->N+1;
+  // Stage offsets
+  for (k=0; k<=p->N; ++k) {
+    n = p->nxs[k] + p->nus[k];
+    nx1 = k<p->N ? p->nxs[k+1] : 0;
+    if (k==0) {
+      d->oz[k] = d->oa[k] = d->om[k] = d->og[k] = d->oe[k] = d->ocd[k] = d->oy[k] = 0;
+    }
+    if (k<p->N) {
+      d->oz[k+1] = d->oz[k] + n;
+      d->oa[k+1] = d->oa[k] + nx1 + p->ngs[k];
+      d->om[k+1] = d->om[k] + n*n;
+      d->og[k+1] = d->og[k] + nx1*n;
+      d->oe[k+1] = d->oe[k] + nx1;
+      d->ocd[k+1] = d->ocd[k] + p->ngs[k]*n;
+      d->oy[k+1] = d->oy[k] + n;
+    } else {
+      n = d->om[k] + n*n;
+      nx1 = d->oe[k];
+      d->m = *w; *w += n;
+      d->gk = *w; *w += d->og[k];
+      d->e = *w; *w += nx1;
+      d->b = *w; *w += nx1;
+      d->c = *w; *w += nx1;
+      d->cd = *w; *w += d->ocd[k] + p->ngs[k]*(p->nxs[k] + p->nus[k]);
+      d->y = *w; *w += d->oy[k] + p->nxs[k] + p->nus[k];
+    }
+  }
+  d->w = *w;
+}
+
+// SYMBOL "ocpqp_pos"
+// Position of a variable of stage k in the stage-wise ordering [u; x]
+template<typename T1>
+casadi_int casadi_ocpqp_pos(const casadi_ocpqp_prob<T1>* p, casadi_int k, casadi_int i) {
+  return i < p->nxs[k] ? p->nus[k] + i : i - p->nxs[k];
+}
+
+// SYMBOL "ocpqp_pchol"
+// Cholesky factorization of the first nf columns of a dense symmetric matrix,
+// in-place. The trailing block is replaced by the (symmetric) Schur complement.
+template<typename T1>
+int casadi_ocpqp_pchol(T1* m, casadi_int n, casadi_int nf) {
+  // Local variables
+  casadi_int i, j, c;
+  T1 r;
+  for (j=0; j<nf; ++j) {
+    r = m[j+j*n];
+    if (!(r > 0)) return 1;
+    r = sqrt(r);
+    m[j+j*n] = r;
+    for (i=j+1; i<n; ++i) m[i+j*n] /= r;
+    for (c=j+1; c<n; ++c) {
+      for (i=c; i<n; ++i) m[i+c*n] -= m[i+j*n]*m[c+j*n];
+    }
+  }
+  for (c=nf; c<n; ++c) {
+    for (i=c+1; i<n; ++i) m[c+i*n] = m[i+c*n];
+  }
+  return 0;
+}
+
+// SYMBOL "ocpqp_pchol_fwd"
+// Forward substitution with the first nf columns of a partial Cholesky factor
+template<typename T1>
+void casadi_ocpqp_pchol_fwd(const T1* m, casadi_int n, casadi_int nf, T1* v) {
+  // Local variables
+  casadi_int i, j;
+  for (j=0; j<nf; ++j) {
+    v[j] /= m[j+j*n];
+    for (i=j+1; i<n; ++i) v[i] -= m[i+j*n]*v[j];
+  }
+}
+
+// SYMBOL "ocpqp_pchol_bwd"
+// Backward substitution with the first nf columns of a partial Cholesky factor
+template<typename T1>
+void casadi_ocpqp_pchol_bwd(const T1* m, casadi_int n, casadi_int nf, T1* v) {
+  // Local variables
+  casadi_int i, j;
+  for (j=nf-1; j>=0; --j) {
+    for (i=j+1; i<n; ++i) v[j] -= m[i+j*n]*v[i];
+    v[j] /= m[j+j*n];
+  }
+}
+
+// SYMBOL "ocpqp_reset"
+template<typename T1>
+int casadi_ocpqp_reset(casadi_ocpqp_data<T1>* d) {
+  // Local variables
+  casadi_int i, j, k, el, r, n, nx1, pj;
+  const casadi_int *a_colind, *a_row;
+  const casadi_ocpqp_prob<T1>* p = d->prob;
+  // Extract sparsity
+  a_row = (a_colind = p->sp_a+2) + p->nx + 1;
+  // Dense stage-wise blocks of A
+  casadi_clear(d->gk, d->og[p->N]);
+  casadi_clear(d->e, d->oe[p->N]);
+  casadi_clear(d->cd, d->ocd[p->N] + p->ngs[p->N]*(p->nxs[p->N] + p->nus[p->N]));
+  for (k=0; k<=p->N; ++k) {
+    n = p->nxs[k] + p->nus[k];
+    nx1 = k<p->N ? p->nxs[k+1] : 0;
+    for (j=0; j<n; ++j) {
+      pj = casadi_ocpqp_pos(p, k, j);
+      for (el=a_colind[d->oz[k]+j]; el<a_colind[d->oz[k]+j+1]; ++el) {
+        r = a_row[el];
+        if (r < d->oa[k]) {
+          // Diagonal entry of the previous dynamics
+          d->e[d->oe[k-1] + r - d->oa[k-1]] = d->nz_a[el];
+        } else if (r < d->oa[k] + nx1) {
+          // Dynamics
+          d->gk[d->og[k] + r - d->oa[k] + pj*nx1] = d->nz_a[el];
+        } else {
+          // Path constraints
+          d->cd[d->ocd[k] + r - d->oa[k] - nx1 + pj*p->ngs[k]] = d->nz_a[el];
+        }
+      }
+    }
+  }
+  // Dynamics as an explicit recursion, x_{k+1} = gk*[u_k; x_k] + c_k
+  for (k=0; k<p->N; ++k) {
+    n = p->nxs[k] + p->nus[k];
+    nx1 = p->nxs[k+1];
+    for (i=0; i<nx1; ++i) {
+      r = p->nx + d->oa[k] + i;
+      // Dynamics must be equality constraints with a nonzero diagonal
+      if (d->lbz[r] != d->ubz[r] || d->e[d->oe[k]+i] == 0) {
+        d->status = OCPQP_BAD_DYNAMICS;
+        return 1;
+      }
+      d->b[d->oe[k]+i] = d->lbz[r];
+      // Not treated as inequality constraints
+      d->lbz[r] = -p->inf;
+      d->ubz[r] = p->inf;
+      for (j=0; j<n; ++j) d->gk[d->og[k] + i + j*nx1] /= -d->e[d->oe[k]+i];
+    }
+  }
+  // Row values of the initial guess
+  casadi_clear(d->z+p->nx, p->na);
+  casadi_mv(d->nz_a, p->sp_a, d->z, d->z+p->nx, 0);
+  // Interior slacks and multipliers
+  casadi_ipm_reset(p->nz, d->z, d->lbz, d->ubz, d->sl, p->inf, 0);
+  // Reset iteration counter
+  d->iter = 0;
+  d->alpha = 0;
+  d->sigma = 0;
+  return 0;
+}
+
+// SYMBOL "ocpqp_prepare"
+template<typename T1>
+int casadi_ocpqp_prepare(casadi_ocpqp_data<T1>* d) {
+  // Local variables
+  casadi_int i, ii, k, el, r, nx1, n_ineq;
+  T1 s;
+  const casadi_int *a_colind, *a_row;
+  const casadi_ocpqp_prob<T1>* p = d->prob;
+  // Extract sparsity
+  a_row = (a_colind = p->sp_a+2) + p->nx + 1;
+  // Row values
+  casadi_clear(d->z+p->nx, p->na);
+  casadi_mv(d->nz_a, p->sp_a, d->z, d->z+p->nx, 0);
+  // Cost
+  d->f = casadi_bilin(d->nz_h, p->sp_h, d->z, d->z)/2. + casadi_dot(p->nx, d->z, d->g);
+  // Multipliers of the bounds and path constraints
+  for (i=0; i<p->nz; ++i) d->lam[i] = d->lamu[i] - d->laml[i];
+  // Gradient of the Lagrangian, excluding the dynamics
+  casadi_copy(d->g, p->nx, d->rd);
+  casadi_mv(d->nz_h, p->sp_h, d->z, d->rd, 0);
+  casadi_axpy(p->nx, 1., d->lam, d->rd);
+  casadi_mv(d->nz_a, p->sp_a, d->lam+p->nx, d->rd, 1);
+  // Multipliers of the dynamics making the gradient w.r.t. x_{k+1} vanish
+  for (k=p->N-1; k>=0; --k) {
+    nx1 = p->nxs[k+1];
+    for (ii=0; ii<nx1; ++ii) {
+      i = d->oz[k+1] + ii;
+      s = d->rd[i];
+      for (el=a_colind[i]; el<a_colind[i+1]; ++el) {
+        r = a_row[el];
+        if (k+1<p->N && r >= d->oa[k+1] && r < d->oa[k+1] + p->nxs[k+2]) {
+          s += d->nz_a[el]*d->lam[p->nx+r];
+        }
+      }
+      d->lam[p->nx + d->oa[k] + ii] = -s/d->e[d->oe[k]+ii];
+    }
+  }
+  // Dual error
+  casadi_copy(d->g, p->nx, d->w);
+  casadi_mv(d->nz_h, p->sp_h, d->z, d->w, 0);
+  casadi_axpy(p->nx, 1., d->lam, d->w);
+  casadi_mv(d->nz_a, p->sp_a, d->lam+p->nx, d->w, 1);
+  // Multipliers of fixed variables and strongly active bounds
+  d->du = casadi_ipm_dual(p->nx, d->lbz, d->ubz, d->sl, d->su, d->laml, d->lamu,
+                          d->lam, d->w, p->inf);
+  // Primal error and complementarity
+  d->pr = 0;
+  d->mu = 0;
+  n_ineq = 0;
+  for (i=0; i<p->nz; ++i) {
+    if (d->lbz[i] > -p->inf) {
+      d->pr = fmax(d->pr, fabs(d->z[i] - d->lbz[i] - d->sl[i]));
+      d->mu += d->sl[i]*d->laml[i];
+      n_ineq++;
+    }
+    if (d->ubz[i] < p->inf) {
+      d->pr = fmax(d->pr, fabs(d->ubz[i] - d->z[i] - d->su[i]));
+      d->mu += d->su[i]*d->lamu[i];
+      n_ineq++;
+    }
+  }
+  if (n_ineq > 0) d->mu /= n_ineq;
+  for (k=0; k<p->N; ++k) {
+    for (ii=0; ii<p->nxs[k+1]; ++ii) {
+      d->pr = fmax(d->pr, fabs(d->z[p->nx + d->oa[k] + ii] - d->b[d->oe[k]+ii]));
+    }
+  }
+  // Termination
+  if (d->pr <= p->tol && d->du <= p->tol && d->mu <= p->tol) {
+    d->status = OCPQP_SUCCESS;
+    return 1;
+  } else if (d->iter >= p->max_iter) {
+    d->status = OCPQP_MAX_ITER;
+    return 1;
+  }
+  return 0;
+}
+
+// SYMBOL "ocpqp_factorize"
+// Riccati recursion: backward block Cholesky factorization of the stage-wise KKT blocks
+template<typename T1>
+int casadi_ocpqp_factorize(casadi_ocpqp_data<T1>* d) {
+  // Local variables
+  casadi_int i, j, k, l, el, n, n1, nx1, nu1, ng, pi, pj;
+  T1 *m, *gk, *cd, *pk;
+  const casadi_int *h_colind, *h_row;
+  const casadi_ocpqp_prob<T1>* p = d->prob;
+  // Extract sparsity
+  h_row = (h_colind = p->sp_h+2) + p->nx + 1;
+  // Barrier weights
+  for (i=0; i<p->nz; ++i) {
+    d->sig[i] = 0;
+    if (d->lbz[i] > -p->inf) d->sig[i] += d->laml[i]/d->sl[i];
+    if (d->ubz[i] < p->inf) d->sig[i] += d->lamu[i]/d->su[i];
+  }
+  for (k=p->N; k>=0; --k) {
+    n = p->nxs[k] + p->nus[k];
+    ng = p->ngs[k];
+    m = d->m + d->om[k];
+    cd = d->cd + d->ocd[k];
+    // Hessian block
+    casadi_clear(m, n*n);
+    for (j=0; j<n; ++j) {
+      pj = casadi_ocpqp_pos(p, k, j);
+      for (el=h_colind[d->oz[k]+j]; el<h_colind[d->oz[k]+j+1]; ++el) {
+        pi = casadi_ocpqp_pos(p, k, h_row[el] - d->oz[k]);
+        m[pi + pj*n] += d->nz_h[el];
+      }
+      m[pj + pj*n] += d->sig[d->oz[k]+j];
+    }
+    // Barrier terms of the path constraints
+    for (l=0; l<ng; ++l) {
+      pk = d->sig + p->nx + d->oa[k] + (k<p->N ? p->nxs[k+1] : 0) + l;
+      if (*pk == 0) continue;
+      for (j=0; j<n; ++j) {
+        if (cd[l + j*ng] == 0) continue;
+        for (i=0; i<n; ++i) m[i + j*n] += cd[l + i*ng] * *pk * cd[l + j*ng];
+      }
+    }
+    // Cost-to-go of the next stage
+    if (k<p->N) {
+      nx1 = p->nxs[k+1];
+      nu1 = p->nus[k+1];
+      n1 = nx1 + nu1;
+      gk = d->gk + d->og[k];
+      pk = d->m + d->om[k+1] + nu1*(n1+1);
+      // w = P_{k+1}*gk
+      for (j=0; j<n; ++j) {
+        for (i=0; i<nx1; ++i) {
+          d->w[i + j*nx1] = 0;
+          for (l=0; l<nx1; ++l) d->w[i + j*nx1] += pk[i + l*n1]*gk[l + j*nx1];
+        }
+      }
+      // m += gk'*w
+      for (j=0; j<n; ++j) {
+        for (i=0; i<n; ++i) m[i + j*n] += casadi_dot(nx1, gk + i*nx1, d->w + j*nx1);
+      }
+    }
+    // Eliminate the controls (and the initial state)
+    if (casadi_ocpqp_pchol(m, n, k==0 ? n : p->nus[k])) return 1;
+  }
+  return 0;
+}
+
+// SYMBOL "ocpqp_solve"
+// Newton step for given complementarity residuals rcl, rcu
+template<typename T1>
+void casadi_ocpqp_solve(casadi_ocpqp_data<T1>* d) {
+  // Local variables
+  casadi_int i, j, k, n, n1, nx1, nu1;
+  T1 rpl, rpu, *y, *y1, *gk, *pk;
+  const casadi_ocpqp_prob<T1>* p = d->prob;
+  // Right-hand side after eliminating slacks and multipliers
+  for (i=0; i<p->nz; ++i) {
+    d->t[i] = 0;
+    if (d->lbz[i] > -p->inf) {
+      rpl = d->z[i] - d->lbz[i] - d->sl[i];
+      d->t[i] -= (d->rcl[i] + d->laml[i]*rpl)/d->sl[i];
+    }
+    if (d->ubz[i] < p->inf) {
+      rpu = d->ubz[i] - d->z[i] - d->su[i];
+      d->t[i] += (d->rcu[i] + d->lamu[i]*rpu)/d->su[i];
+    }
+  }
+  casadi_copy(d->t, p->nx, d->q);
+  casadi_mv(d->nz_a, p->sp_a, d->t+p->nx, d->q, 1);
+  for (i=0; i<p->nx; ++i) d->q[i] = d->rd[i] - d->q[i];
+  // Dynamics residuals
+  for (k=0; k<p->N; ++k) {
+    for (i=0; i<p->nxs[k+1]; ++i) {
+      d->c[d->oe[k]+i] = (d->z[p->nx + d->oa[k] + i] - d->b[d->oe[k]+i])/d->e[d->oe[k]+i];
+    }
+  }
+  // Backward recursion
+  for (k=p->N; k>=0; --k) {
+    n = p->nxs[k] + p->nus[k];
+    y = d->y + d->oy[k];
+    for (j=0; j<n; ++j) y[casadi_ocpqp_pos(p, k, j)] = d->q[d->oz[k]+j];
+    if (k<p->N) {
+      nx1 = p->nxs[k+1];
+      nu1 = p->nus[k+1];
+      n1 = nx1 + nu1;
+      gk = d->gk + d->og[k];
+      pk = d->m + d->om[k+1] + nu1*(n1+1);
+      y1 = d->y + d->oy[k+1] + nu1;
+      // w = P_{k+1}*c_k + p_{k+1}
+      for (i=0; i<nx1; ++i) {
+        d->w[i] = -y1[i];
+        for (j=0; j<nx1; ++j) d->w[i] -= pk[i + j*n1]*d->c[d->oe[k]+j];
+      }
+      // y += gk'*w
+      for (j=0; j<n; ++j) y[j] += casadi_dot(nx1, gk + j*nx1, d->w);
+    }
+    casadi_scal(n, -1., y);
+    casadi_ocpqp_pchol_fwd(d->m + d->om[k], n, k==0 ? n : p->nus[k], y);
+  }
+  // Forward recursion
+  for (k=0; k<=p->N; ++k) {
+    n = p->nxs[k] + p->nus[k];
+    y = d->y + d->oy[k];
+    if (k>0) {
+      // x_k = gk*[u; x]_{k-1} - c_{k-1}
+      nx1 = p->nxs[k];
+      gk = d->gk + d->og[k-1];
+      y1 = d->y + d->oy[k-1];
+      for (i=0; i<nx1; ++i) y[p->nus[k]+i] = -d->c[d->oe[k-1]+i];
+      for (j=0; j<p->nxs[k-1] + p->nus[k-1]; ++j) {
+        casadi_axpy(nx1, y1[j], gk + j*nx1, y + p->nus[k]);
+      }
+    }
+    casadi_ocpqp_pchol_bwd(d->m + d->om[k], n, k==0 ? n : p->nus[k], y);
+    for (j=0; j<n; ++j) d->dz[d->oz[k]+j] = y[casadi_ocpqp_pos(p, k, j)];
+  }
+  // Step in the slacks and multipliers
+  casadi_clear(d->dz+p->nx, p->na);
+  casadi_mv(d->nz_a, p->sp_a, d->dz, d->dz+p->nx, 0);
+  for (i=0; i<p->nz; ++i) {
+    d->dsl[i] = d->dlaml[i] = d->dsu[i] = d->dlamu[i] = 0;
+    if (d->lbz[i] > -p->inf) {
+      d->dsl[i] = d->z[i] + d->dz[i] - d->lbz[i] - d->sl[i];
+      d->dlaml[i] = -(d->rcl[i] + d->laml[i]*d->dsl[i])/d->sl[i];
+    }
+    if (d->ubz[i] < p->inf) {
+      d->dsu[i] = d->ubz[i] - d->z[i] - d->dz[i] - d->su[i];
+      d->dlamu[i] = -(d->rcu[i] + d->lamu[i]*d->dsu[i])/d->su[i];
+    }
+  }
+}
+
+// SYMBOL "ocpqp_iterate"
+// Mehrotra predictor-corrector step
+template<typename T1>
+int casadi_ocpqp_iterate(casadi_ocpqp_data<T1>* d) {
+  // Local variables
+  const casadi_ocpqp_prob<T1>* p = d->prob;
+  // Start a new iteration
+  d->iter++;
+  // Factorize the KKT system
+  if (casadi_ocpqp_factorize(d)) {
+    d->status = OCPQP_NOT_CONVEX;
+    return 1;
+  }
+  // Affine scaling (predictor) step
+  casadi_ipm_predictor(p->nz, d->sl, d->rcl);
+  casadi_ocpqp_solve(d);
+  // Centering parameter, corrector step
+  d->sigma = casadi_ipm_corrector(p->nz, d->sl, d->dsl, d->rcl, d->mu);
+  casadi_ocpqp_solve(d);
+  // Step size, stay in the interior
+  d->alpha = fmin(1., 0.995*casadi_ipm_max_step(p->nz, d->sl, d->dsl));
+  // Take step
+  casadi_axpy(p->nx, d->alpha, d->dz, d->z);
+  casadi_axpy(4*p->nz, d->alpha, d->dsl, d->sl);
+  return 0;
+}
@@ -24,6 +24,8 @@ struct casadi_qp_prob {
   casadi_int max_iter;
   // Primal and dual error tolerance
   T1 constr_viol_tol, dual_inf_tol;
+  // Maximum number of active-set changes handled by low-rank updates
+  casadi_int max_update;
 };
 // C-REPLACE "casadi_qp_prob<T1>" "struct casadi_qp_prob"
 
@@ -39,6 +41,7 @@ void casadi_qp_setup(casadi_qp_prob<T1>* p) {
   p->max_iter = 1000;
   p->constr_viol_tol = 1e-8;
   p->dual_inf_tol = 1e-8;
+  p->max_update = 0;
 }
 
 // SYMBOL "qp_work"
@@ -75,6 +78,13 @@ void casadi_qp_work(const casadi_qp_prob<T1>* p, casadi_int* sz_iw, casadi_int*
   *sz_iw += p->nz; // lincomb
   *sz_w += casadi_max(nnz_v+nnz_r, nnz_kkt); // [v,r] or trans(kkt)
   *sz_w += p->nz; // beta
+  if (p->max_update > 0) {
+    *sz_w += 2*p->nz*p->max_update; // up_u, up_y
+    *sz_w += p->max_update*p->max_update; // up_s
+    *sz_w += p->max_update + p->nz + casadi_max(p->nz, p->sp_v[0]); // up_w
+    *sz_iw += 2*p->max_update; // up_ind, up_piv
+    *sz_iw += p->nz; // qr_as
+  }
 }
 
 // SYMBOL "qp_flag_t"
@@ -101,6 +111,12 @@ struct casadi_qp_data {
   casadi_int *iw, *neverzero, *neverlower, *neverupper, *lincomb;
   // Numeric QR factorization
   T1 *nz_at, *nz_kkt, *beta, *nz_v, *nz_r;
+  // Active set (lam!=0) of the current factorization, if kept for reuse
+  casadi_int* qr_as;
+  // Low-rank updates of the factorization: modified columns, their changes,
+  // solutions with the factorization and the Schur complement
+  casadi_int nup, *up_ind, *up_piv;
+  T1 *up_u, *up_y, *up_s, *up_w;
   // Message buffer
   const char *msg;
   // Message index
@@ -155,6 +171,19 @@ void casadi_qp_init(casadi_qp_data<T1>* d, casadi_int** iw, T1** w) {
   d->neverupper = *iw; *iw += p->nz;
   d->neverlower = *iw; *iw += p->nz;
   d->lincomb = *iw; *iw += p->nz;
+  d->qr_as = 0;
+  d->nup = 0;
+  if (p->max_update > 0) {
+    d->up_u = *w; *w += p->nz*p->max_update;
+    d->up_y = *w; *w += p->nz*p->max_update;
+    d->up_s = *w; *w += p->max_update*p->max_update;
+    d->up_w = *w; *w += p->max_update + p->nz + casadi_max(p->nz, p->sp_v[0]);
+    d->up_ind = *iw; *iw += p->max_update;
+    d->up_piv = *iw; *iw += p->max_update;
+    // No factorization yet
+    d->qr_as = *iw; *iw += p->nz;
+    if (p->nz > 0) d->qr_as[0] = -1;
+  }
   d->w = *w;
   d->iw = *iw;
 }
@@ -649,6 +678,21 @@ void casadi_qp_take_step(casadi_qp_data<T1>* d) {
   }
 }
 
+// SYMBOL "qp_linsol"
+template<typename T1>
+void casadi_qp_linsol(casadi_qp_data<T1>* d, T1* x, casadi_int tr) {
+  const casadi_qp_prob<T1>* p = d->prob;
+  if (d->nup > 0) {
+    // Factorization with low-rank updates
+    casadi_qr_update_solve(x, tr, p->sp_v, d->nz_v, p->sp_r, d->nz_r, d->beta,
+                           p->prinv, p->pc, d->nup, d->up_ind, d->up_u, d->up_y,
+                           d->up_s, d->up_piv, d->up_w);
+  } else {
+    casadi_qr_solve(x, 1, tr, p->sp_v, d->nz_v, p->sp_r, d->nz_r, d->beta,
+                    p->prinv, p->pc, d->w);
+  }
+}
+
 // SYMBOL "qp_flip_check"
 template<typename T1>
 int casadi_qp_flip_check(casadi_qp_data<T1>* d) {
@@ -658,15 +702,13 @@ int casadi_qp_flip_check(casadi_qp_data<T1>* d) {
   // Calculate the difference between old and new column index
   if (d->sign == 0) casadi_scal(p->nz, -1., d->dlam);
   // Try to find a linear combination of the new columns
-  casadi_qr_solve(d->dlam, 1, 0, p->sp_v, d->nz_v, p->sp_r, d->nz_r, d->beta,
-    p->prinv, p->pc, d->w);
+  casadi_qp_linsol(d, d->dlam, 0);
   // If dlam[index]!=1, new columns must be linearly independent
   if (fabs(d->dlam[d->index]-1.) >= 1e-12) return 0;
   // Next, find a linear combination of the new rows
   casadi_clear(d->dz, p->nz);
   d->dz[d->index] = 1;
-  casadi_qr_solve(d->dz, 1, 1, p->sp_v, d->nz_v, p->sp_r, d->nz_r, d->beta,
-    p->prinv, p->pc, d->w);
+  casadi_qp_linsol(d, d->dz, 1);
   // Normalize dlam, dz
   casadi_scal(p->nz, 1./sqrt(casadi_dot(p->nz, d->dlam, d->dlam)), d->dlam);
   casadi_scal(p->nz, 1./sqrt(casadi_dot(p->nz, d->dz, d->dz)), d->dz);
@@ -674,20 +716,80 @@ int casadi_qp_flip_check(casadi_qp_data<T1>* d) {
   return 1;
 }
 
+// SYMBOL "qp_update"
+// C-REPLACE "static_cast<T1*>(0)" "0"
+template<typename T1>
+int casadi_qp_update(casadi_qp_data<T1>* d) {
+  // Local variables
+  casadi_int i, j, k;
+  const casadi_qp_prob<T1>* p = d->prob;
+  // The factorization to be updated must be regular
+  if (casadi_qr_singular(static_cast<T1*>(0), 0, d->nz_r, p->sp_r, p->pc, 1e-12)) return 1;
+  // Remove constraints that are back to the factorized status
+  for (j=0; j<d->nup; ) {
+    i = d->up_ind[j];
+    if (d->qr_as[i] == (d->lam[i]!=0.)) {
+      k = --d->nup;
+      d->up_ind[j] = d->up_ind[k];
+      casadi_copy(d->up_u + k*p->nz, p->nz, d->up_u + j*p->nz);
+      casadi_copy(d->up_y + k*p->nz, p->nz, d->up_y + j*p->nz);
+    } else {
+      j++;
+    }
+  }
+  // Add constraints with a changed status
+  for (i=0; i<p->nz; ++i) {
+    if (d->qr_as[i] == (d->lam[i]!=0.)) continue;
+    for (j=0; j<d->nup; ++j) if (d->up_ind[j]==i) break;
+    if (j<d->nup) continue;
+    if (d->nup==p->max_update) return 1;
+    // Change in column i, from unenforced to enforced or vice versa
+    d->up_ind[d->nup] = i;
+    casadi_qp_kkt_vector(d, d->up_u + d->nup*p->nz, i);
+    if (d->lam[i]!=0.) casadi_scal(p->nz, -1., d->up_u + d->nup*p->nz);
+    // Solve with the factorization
+    casadi_copy(d->up_u + d->nup*p->nz, p->nz, d->up_y + d->nup*p->nz);
+    casadi_qr_solve(d->up_y + d->nup*p->nz, 1, 0, p->sp_v, d->nz_v, p->sp_r, d->nz_r,
+                    d->beta, p->prinv, p->pc, d->w);
+    d->nup++;
+  }
+  // Factorize the Schur complement
+  return casadi_qr_update(d->up_s, d->up_piv, d->up_y, d->up_ind, p->nz, d->nup, 1e-12);
+}
+
 // SYMBOL "qp_factorize"
 template<typename T1>
 void casadi_qp_factorize(casadi_qp_data<T1>* d) {
+  // Local variables
+  casadi_int i, n_mod;
   const casadi_qp_prob<T1>* p = d->prob;
   // Do we already have a search direction due to lost singularity?
   if (d->has_search_dir) {
     d->sing = 1;
     return;
   }
-  // Construct the KKT matrix
-  casadi_qp_kkt(d);
-  // QR factorization
-  casadi_qr(p->sp_kkt, d->nz_kkt, d->w, p->sp_v, d->nz_v, p->sp_r,
-            d->nz_r, d->beta, p->prinv, p->pc);
+  // Number of constraints with a different status than in the factorization
+  n_mod = -1;
+  if (d->qr_as && (p->nz==0 || d->qr_as[0]>=0)) {
+    n_mod = 0;
+    for (i=0; i<p->nz; ++i) if (d->qr_as[i] != (d->lam[i]!=0.)) n_mod++;
+  }
+  // Low-rank updates are not carried over from a previous solve
+  if (d->iter > 0 && n_mod > 0 && n_mod <= p->max_update && !casadi_qp_update(d)) {
+    // Low-rank update of a regular factorization
+    d->sing = 0;
+    return;
+  }
+  if (n_mod != 0) {
+    // Construct the KKT matrix
+    casadi_qp_kkt(d);
+    // QR factorization
+    casadi_qr(p->sp_kkt, d->nz_kkt, d->w, p->sp_v, d->nz_v, p->sp_r,
+              d->nz_r, d->beta, p->prinv, p->pc);
+    // Keep track of the active set
+    if (d->qr_as) for (i=0; i<p->nz; ++i) d->qr_as[i] = d->lam[i]!=0.;
+  }
+  d->nup = 0;
   // Check singularity
   d->sing = casadi_qr_singular(&d->mina, &d->imina, d->nz_r, p->sp_r, p->pc, 1e-12);
 }
@@ -807,6 +909,9 @@ int casadi_qp_singular_step(casadi_qp_data<T1>* d) {
     casadi_copy(d->nz_v, nnz_kkt, d->nz_kkt);
     casadi_qr(p->sp_kkt, d->nz_kkt, d->w, p->sp_v, d->nz_v, p->sp_r, d->nz_r,
               d->beta, p->prinv, p->pc);
+    // The factorization no longer corresponds to an active set
+    if (d->qr_as && p->nz > 0) d->qr_as[0] = -1;
+    d->nup = 0;
     // For all nullspace vectors
     nk = casadi_qr_singular(static_cast<T1*>(0), 0, d->nz_r, p->sp_r, p->pc, 1e-12);
   }
@@ -904,8 +1009,6 @@ int casadi_qp_singular_step(casadi_qp_data<T1>* d) {
 // SYMBOL "qp_calc_step"
 template<typename T1>
 int casadi_qp_calc_step(casadi_qp_data<T1>* d) {
-  // Local variables
-  const casadi_qp_prob<T1>* p = d->prob;
   // Reset returns
   d->r_index = -1;
   d->r_sign = 0;
@@ -914,8 +1017,7 @@ int casadi_qp_calc_step(casadi_qp_data<T1>* d) {
   // Negative KKT residual
   casadi_qp_kkt_residual(d, d->dz);
   // Solve to get step in z[:nx] and lam[nx:]
-  casadi_qr_solve(d->dz, 1, 1, p->sp_v, d->nz_v, p->sp_r, d->nz_r, d->beta,
-                  p->prinv, p->pc, d->w);
+  casadi_qp_linsol(d, d->dz, 1);
   // Have step in dz[:nx] and dlam[nx:]. Calculate complete dz and dlam
   casadi_qp_expand_step(d);
   // Successful return
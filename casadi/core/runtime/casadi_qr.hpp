@@ -252,3 +252,109 @@ void casadi_qr_colcomb(T1* v, const T1* nz_r, const casadi_int* sp_r,
   // Normalize v
   casadi_scal(ncol, 1./sqrt(casadi_dot(ncol, v, v)), v);
 }
+
+// SYMBOL "qr_update"
+// Low-rank modification A = A0 + U*E' of a QR-factorized square matrix A0,
+// replacing the columns ind[0], ..., ind[k-1] (E = [e_ind[0], ..., e_ind[k-1]]).
+// Given Y = A0 \ U, form and LU-factorize (partial pivoting, in place) the
+// Schur complement S = I + E'*Y. Returns 1 if S, and hence A, is singular.
+// len[y] = n*k, len[s] = k*k, len[piv] = k
+template<typename T1>
+int casadi_qr_update(T1* s, casadi_int* piv, const T1* y, const casadi_int* ind,
+                     casadi_int n, casadi_int k, T1 eps) {
+  // Local variables
+  casadi_int i, j, c, p;
+  T1 t;
+  // Form the Schur complement
+  for (c=0; c<k; ++c) {
+    for (i=0; i<k; ++i) s[i+c*k] = y[ind[i]+c*n];
+    s[c+c*k] += 1.;
+  }
+  // LU factorization with partial pivoting
+  for (j=0; j<k; ++j) {
+    // Find pivot
+    p = j;
+    for (i=j+1; i<k; ++i) if (fabs(s[i+j*k]) > fabs(s[p+j*k])) p = i;
+    piv[j] = p;
+    if (fabs(s[p+j*k]) < eps) return 1;
+    // Swap rows
+    if (p!=j) {
+      for (c=0; c<k; ++c) {
+        t = s[j+c*k];
+        s[j+c*k] = s[p+c*k];
+        s[p+c*k] = t;
+      }
+    }
+    // Eliminate
+    for (i=j+1; i<k; ++i) s[i+j*k] /= s[j+j*k];
+    for (c=j+1; c<k; ++c) {
+      for (i=j+1; i<k; ++i) s[i+c*k] -= s[i+j*k]*s[j+c*k];
+    }
+  }
+  return 0;
+}
+
+// SYMBOL "qr_update_solve"
+// Solve (A0 + U*E') x = b (tr=0) or its transpose (tr=1), with A0 factorized
+// by casadi_qr and the modification prepared by casadi_qr_update
+// len[w] >= k + ncol + max(ncol, nrow_ext)
+template<typename T1>
+void casadi_qr_update_solve(T1* x, casadi_int tr,
+                            const casadi_int* sp_v, const T1* v, const casadi_int* sp_r,
+                            const T1* r, const T1* beta, const casadi_int* prinv,
+                            const casadi_int* pc, casadi_int k, const casadi_int* ind,
+                            const T1* u, const T1* y, const T1* s, const casadi_int* piv,
+                            T1* w) {
+  // Local variables
+  casadi_int n, i, j;
+  T1 *c, *t, tmp;
+  // Work vectors
+  n = sp_v[1];
+  c = w; w += k;
+  t = w; w += n;
+  // Solve with A0 or A0'
+  casadi_qr_solve(x, 1, tr, sp_v, v, sp_r, r, beta, prinv, pc, w);
+  if (k==0) return;
+  if (!tr) {
+    // c = S \ (E'*x)
+    for (j=0; j<k; ++j) c[j] = x[ind[j]];
+    for (j=0; j<k; ++j) {
+      if (piv[j]!=j) {
+        tmp = c[j];
+        c[j] = c[piv[j]];
+        c[piv[j]] = tmp;
+      }
+    }
+    for (j=0; j<k; ++j) {
+      for (i=j+1; i<k; ++i) c[i] -= s[i+j*k]*c[j];
+    }
+    for (j=k-1; j>=0; --j) {
+      c[j] /= s[j+j*k];
+      for (i=0; i<j; ++i) c[i] -= s[i+j*k]*c[j];
+    }
+    // x -= Y*c
+    for (j=0; j<k; ++j) casadi_axpy(n, -c[j], y+j*n, x);
+  } else {
+    // c = S' \ (U'*x)
+    for (j=0; j<k; ++j) c[j] = casadi_dot(n, u+j*n, x);
+    for (j=0; j<k; ++j) {
+      for (i=0; i<j; ++i) c[j] -= s[i+j*k]*c[i];
+      c[j] /= s[j+j*k];
+    }
+    for (j=k-1; j>=0; --j) {
+      for (i=j+1; i<k; ++i) c[j] -= s[i+j*k]*c[i];
+    }
+    for (j=k-1; j>=0; --j) {
+      if (piv[j]!=j) {
+        tmp = c[j];
+        c[j] = c[piv[j]];
+        c[piv[j]] = tmp;
+      }
+    }
+    // x -= A0' \ (E*c)
+    casadi_clear(t, n);
+    for (j=0; j<k; ++j) t[ind[j]] += c[j];
+    casadi_qr_solve(t, 1, 1, sp_v, v, sp_r, r, beta, prinv, pc, w);
+    casadi_axpy(n, -1., t, x);
+  }
+}
@@ -262,14 +262,20 @@ namespace casadi {
   #include "casadi_interpn.hpp"
   #include "casadi_interpn_grad.hpp"
   #include "casadi_mv_dense.hpp"
+  #include "casadi_mtimes_dense.hpp"
+  #include "casadi_mtimes_sparse_dense.hpp"
   #include "casadi_finite_diff.hpp"
   #include "casadi_file_slurp.hpp"
   #include "casadi_ldl.hpp"
   #include "casadi_qr.hpp"
   #include "casadi_qp.hpp"
+  #include "casadi_ipm.hpp"
+  #include "casadi_ocpqp.hpp"
+  #include "casadi_ipqp.hpp"
   #include "casadi_nlp.hpp"
   #include "casadi_sqpmethod.hpp"
   #include "casadi_bfgs.hpp"
+  #include "casadi_lbfgs.hpp"
   #include "casadi_regularize.hpp"
   #include "casadi_newton.hpp"
   #include "casadi_bound_consistency.hpp"
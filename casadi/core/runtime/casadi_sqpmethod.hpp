@@ -10,6 +10,8 @@ struct casadi_sqpmethod_prob {
   const casadi_int *sp_h, *sp_a, *sp_hr;
   casadi_int merit_memsize;
   casadi_int max_iter_ls;
+  // Number of pairs stored by the limited-memory Hessian approximation
+  casadi_int lbfgs_memory;
 };
 // C-REPLACE "casadi_sqpmethod_prob<T1>" "struct casadi_sqpmethod_prob"
 
@@ -31,6 +33,8 @@ struct casadi_sqpmethod_data {
   T1 *dx, *dlam;
   // Hessian approximation
   T1 *Bk;
+  // Steps and Lagrangian gradient differences for limited-memory BFGS
+  T1 *Sk, *Yk;
   // Jacobian
   T1* Jk;
   // merit_mem
@@ -66,6 +70,8 @@ void casadi_sqpmethod_work(const casadi_sqpmethod_prob<T1>* p,
   *sz_w += nx + ng; // dlam
   // Hessian approximation
   *sz_w += nnz_h; // Bk
+  *sz_w += nx*p->lbfgs_memory; // Sk
+  *sz_w += nx*p->lbfgs_memory; // Yk
   // Jacobian
   *sz_w += nnz_a; // Jk
   // merit_mem
@@ -100,6 +106,8 @@ void casadi_sqpmethod_init(casadi_sqpmethod_data<T1>* d, casadi_int** iw, T1** w
   d->dlam = *w; *w += nx + ng;
   // Hessian approximation
   d->Bk = *w; *w += nnz_h;
+  d->Sk = *w; *w += nx*p->lbfgs_memory;
+  d->Yk = *w; *w += nx*p->lbfgs_memory;
   // Jacobian
   d->Jk = *w; *w += nnz_a;
   // merit_mem
@@ -31,6 +31,13 @@
 #include "importer.hpp"
 #include "generic_type.hpp"
 #include <iomanip>
+#include <iterator>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif // _WIN32
 
 using namespace std;
 namespace casadi {
@@ -104,9 +111,83 @@ namespace casadi {
       deserializer_(new DeserializingStream(*dstream_)) {
     }
 
-    FileDeserializer::FileDeserializer(const std::string& fname) :
-        DeserializerBase(std::unique_ptr<std::istream>(
-          new std::ifstream(fname, ios_base::binary | std::ios::in))) {
+    /** \brief Input stream reading from a memory-mapped file
+
+        The file contents are read directly from the page cache, without
+        buffering through a file stream.
+    */
+    class MappedFileStream : public std::istream {
+    public:
+      explicit MappedFileStream(const std::string& fname) : std::istream(&buf_) {
+        if (!buf_.open(fname)) setstate(std::ios::failbit);
+      }
+    private:
+      class Buffer : public std::streambuf {
+      public:
+        Buffer() : data_(nullptr), size_(0) {}
+        ~Buffer() {
+#ifndef _WIN32
+          if (data_) munmap(data_, size_);
+#endif // _WIN32
+        }
+        bool open(const std::string& fname) {
+#ifndef _WIN32
+          int fd = ::open(fname.c_str(), O_RDONLY);
+          if (fd<0) return false;
+          struct stat st;
+          if (fstat(fd, &st)) {
+            ::close(fd);
+            return false;
+          }
+          size_ = st.st_size;
+          if (size_>0) {
+            void* p = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p==MAP_FAILED) {
+              ::close(fd);
+              return false;
+            }
+            data_ = static_cast<char*>(p);
+            // Deserialization reads sequentially
+            madvise(data_, size_, MADV_SEQUENTIAL);
+          }
+          ::close(fd);
+          setg(data_, data_, data_+size_);
+          return true;
+#else // _WIN32
+          // No mmap, read the whole file at once
+          std::ifstream in(fname, ios_base::binary);
+          if (!in.good()) return false;
+          contents_.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+          setg(&contents_[0], &contents_[0], &contents_[0]+contents_.size());
+          return true;
+#endif // _WIN32
+        }
+      private:
+        char* data_;
+        size_t size_;
+#ifdef _WIN32
+        std::vector<char> contents_;
+#endif // _WIN32
+      };
+      Buffer buf_;
+    };
+
+    // Input stream for FileDeserializer
+    static std::istream* file_deserializer_stream(const std::string& fname, const Dict& opts) {
+      bool use_mmap = false;
+      for (auto&& op : opts) {
+        if (op.first=="mmap") {
+          use_mmap = op.second;
+        } else {
+          casadi_error("Unknown option: '" + op.first + "'.");
+        }
+      }
+      if (use_mmap) return new MappedFileStream(fname);
+      return new std::ifstream(fname, ios_base::binary | std::ios::in);
+    }
+
+    FileDeserializer::FileDeserializer(const std::string& fname, const Dict& opts) :
+        DeserializerBase(std::unique_ptr<std::istream>(file_deserializer_stream(fname, opts))) {
       if ((dstream_->rdstate() & std::ifstream::failbit) != 0) {
         casadi_error("Could not open file '" + fname + "' for reading.");
       }
@@ -241,8 +241,11 @@ namespace casadi {
      /** \brief Advanced deserialization of CasADi objects
      * 
      * \seealso FileSerializer
+     *
+     * Options: "mmap" (bool): map the file into memory instead of reading it
+     * through a file stream
      */
-    FileDeserializer(const std::string& fname);
+    FileDeserializer(const std::string& fname, const Dict& opts = Dict());
     ~FileDeserializer();
   };
 
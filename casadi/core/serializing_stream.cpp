@@ -42,11 +42,25 @@ namespace casadi {
     static casadi_int serialization_protocol_version = 3;
     static casadi_int serialization_check = 123456789012345;
 
-    DeserializingStream::DeserializingStream(std::istream& in_s) : in(in_s), debug_(false) {
+    // Header of the binary format, cannot be confused with the text encoding
+    static const char binary_magic[] = "CASADIB1";
+
+    DeserializingStream::DeserializingStream(std::istream& in_s) :
+        in(in_s), debug_(false), binary_(false), pos_(0) {
 
       casadi_assert(in_s.good(), "Invalid input stream. If you specified an input file, "
         "make sure it exists relative to the current directory.");
 
+      // Binary format?
+      if (in.peek()==binary_magic[0]) {
+        char magic[8];
+        in.read(magic, 8);
+        casadi_assert(in.gcount()==8 && std::equal(magic, magic+8, binary_magic),
+          "DeserializingStream: corrupt header.");
+        binary_ = true;
+        pos_ = 8;
+      }
+
       // Sanity check
       casadi_int check;
       unpack(check);
@@ -73,27 +87,118 @@ namespace casadi {
     }
 
     SerializingStream::SerializingStream(std::ostream& out_s, const Dict& opts) :
-        out(out_s), debug_(false) {
-      // Sanity check
-      pack(serialization_check);
-      // API version check
-      pack(casadi_int(serialization_protocol_version));
-
+        out(out_s), debug_(false), binary_(false), pos_(0) {
       bool debug = false;
 
       // Read options
       for (auto&& op : opts) {
         if (op.first=="debug") {
           debug = op.second;
+        } else if (op.first=="binary") {
+          binary_ = op.second;
         } else {
           casadi_error("Unknown option: '" + op.first + "'.");
         }
       }
 
+      // Binary format header
+      if (binary_) {
+        out.write(binary_magic, 8);
+        pos_ = 8;
+      }
+
+      // Sanity check
+      pack(serialization_check);
+      // API version check
+      pack(casadi_int(serialization_protocol_version));
+
       pack(debug);
       debug_ = debug;
     }
 
+    void SerializingStream::pack_bytes(const char* c, size_t n) {
+      if (binary_) {
+        out.write(c, n);
+        pos_ += n;
+      } else {
+        for (size_t j=0;j<n;++j) pack(c[j]);
+      }
+    }
+
+    void DeserializingStream::unpack_bytes(char* c, size_t n) {
+      if (binary_) {
+        in.read(c, n);
+        casadi_assert(static_cast<size_t>(in.gcount())==n,
+          "DeserializingStream: unexpected end of stream.");
+        pos_ += n;
+      } else {
+        for (size_t j=0;j<n;++j) unpack(c[j]);
+      }
+    }
+
+    void SerializingStream::pack_array(const char* c, size_t n) {
+      if (binary_) {
+        // Pad to 8-byte alignment, so that the array is aligned when the stream is mapped
+        static const char zeros[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+        size_t pad = (8 - pos_ % 8) % 8;
+        out.write(zeros, pad);
+        pos_ += pad;
+      }
+      pack_bytes(c, 8*n);
+    }
+
+    void DeserializingStream::unpack_array(char* c, size_t n) {
+      if (binary_) {
+        char pad[8];
+        unpack_bytes(pad, (8 - pos_ % 8) % 8);
+      }
+      unpack_bytes(c, 8*n);
+    }
+
+    void SerializingStream::pack(const std::vector<casadi_int>& e) {
+      decorate('V');
+      pack(static_cast<casadi_int>(e.size()));
+      if (binary_ && !debug_ && sizeof(casadi_int)==8) {
+        pack_array(reinterpret_cast<const char*>(get_ptr(e)), e.size());
+      } else {
+        for (casadi_int i : e) pack(i);
+      }
+    }
+
+    void DeserializingStream::unpack(std::vector<casadi_int>& e) {
+      assert_decoration('V');
+      casadi_int s;
+      unpack(s);
+      e.resize(s);
+      if (binary_ && !debug_ && sizeof(casadi_int)==8) {
+        unpack_array(reinterpret_cast<char*>(get_ptr(e)), e.size());
+      } else {
+        for (casadi_int& i : e) unpack(i);
+      }
+    }
+
+    void SerializingStream::pack(const std::vector<double>& e) {
+      decorate('V');
+      pack(static_cast<casadi_int>(e.size()));
+      if (binary_ && !debug_) {
+        pack_array(reinterpret_cast<const char*>(get_ptr(e)), e.size());
+      } else {
+        for (double i : e) pack(i);
+      }
+    }
+
+    void DeserializingStream::unpack(std::vector<double>& e) {
+      assert_decoration('V');
+      casadi_int s;
+      unpack(s);
+      e.resize(s);
+      if (binary_ && !debug_) {
+        unpack_array(reinterpret_cast<char*>(get_ptr(e)), e.size());
+      } else {
+        for (double& i : e) unpack(i);
+      }
+    }
+
     void SerializingStream::decorate(char e) {
       if (debug_) pack(e);
     }
@@ -109,49 +214,40 @@ namespace casadi {
     void DeserializingStream::unpack(casadi_int& e) {
       assert_decoration('J');
       int64_t n;
-      char* c = reinterpret_cast<char*>(&n);
-
-      for (int j=0;j<8;++j) unpack(c[j]);
+      unpack_bytes(reinterpret_cast<char*>(&n), 8);
       e = n;
     }
 
     void SerializingStream::pack(casadi_int e) {
       decorate('J');
       int64_t n = e;
-      const char* c = reinterpret_cast<const char*>(&n);
-      for (int j=0;j<8;++j) pack(c[j]);
+      pack_bytes(reinterpret_cast<const char*>(&n), 8);
     }
 
     void SerializingStream::pack(size_t e) {
       decorate('K');
       uint64_t n = e;
-      const char* c = reinterpret_cast<const char*>(&n);
-      for (int j=0;j<8;++j) pack(c[j]);
+      pack_bytes(reinterpret_cast<const char*>(&n), 8);
     }
 
     void DeserializingStream::unpack(size_t& e) {
       assert_decoration('K');
       uint64_t n;
-      char* c = reinterpret_cast<char*>(&n);
-
-      for (int j=0;j<8;++j) unpack(c[j]);
+      unpack_bytes(reinterpret_cast<char*>(&n), 8);
       e = n;
     }
 
     void DeserializingStream::unpack(int& e) {
       assert_decoration('i');
       int32_t n;
-      char* c = reinterpret_cast<char*>(&n);
-
-      for (int j=0;j<4;++j) unpack(c[j]);
+      unpack_bytes(reinterpret_cast<char*>(&n), 4);
       e = n;
     }
 
     void SerializingStream::pack(int e) {
       decorate('i');
       int32_t n = e;
-      const char* c = reinterpret_cast<const char*>(&n);
-      for (int j=0;j<4;++j) pack(c[j]);
+      pack_bytes(reinterpret_cast<const char*>(&n), 4);
     }
 
     void DeserializingStream::unpack(bool& e) {
@@ -167,6 +263,11 @@ namespace casadi {
     }
 
     void DeserializingStream::unpack(char& e) {
+      if (binary_) {
+        casadi_assert(in.get(e), "DeserializingStream: unexpected end of stream.");
+        pos_++;
+        return;
+      }
       unsigned char ref = 'a';
       in.get(e);
       char t;
@@ -176,6 +277,11 @@ namespace casadi {
     }
 
     void SerializingStream::pack(char e) {
+      if (binary_) {
+        out.put(e);
+        pos_++;
+        return;
+      }
       unsigned char ref = 'a';
       // Note: outputstreams work neatly with std::hex,
       // but inputstreams don't
@@ -187,8 +293,7 @@ namespace casadi {
       decorate('s');
       int s = e.size();
       pack(s);
-      const char* c = e.c_str();
-      for (int j=0;j<s;++j) pack(c[j]);
+      pack_bytes(e.c_str(), s);
     }
 
     void DeserializingStream::unpack(std::string& e) {
@@ -196,19 +301,17 @@ namespace casadi {
       int s;
       unpack(s);
       e.resize(s);
-      for (int j=0;j<s;++j) unpack(e[j]);
+      if (s>0) unpack_bytes(&e[0], s);
     }
 
     void DeserializingStream::unpack(double& e) {
       assert_decoration('d');
-      char* c = reinterpret_cast<char*>(&e);
-      for (int j=0;j<8;++j) unpack(c[j]);
+      unpack_bytes(reinterpret_cast<char*>(&e), 8);
     }
 
     void SerializingStream::pack(double e) {
       decorate('d');
-      const char* c = reinterpret_cast<const char*>(&e);
-      for (int j=0;j<8;++j) pack(c[j]);
+      pack_bytes(reinterpret_cast<const char*>(&e), 8);
     }
 
     void SerializingStream::pack(const Sparsity& e) {
@@ -281,9 +384,7 @@ namespace casadi {
       for (size_t i=0;i<len;++i) {
         s.read(buffer, 1024);
         size_t c = s.gcount();
-        for (size_t j=0;j<c;++j) {
-          pack(buffer[j]);
-        }
+        pack_bytes(buffer, c);
         if (s.rdstate() & std::ifstream::eofbit) break;
       }
     }
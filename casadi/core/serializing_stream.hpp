@@ -61,6 +61,12 @@ namespace casadi {
   typedef std::map<std::string, GenericType> Dict;
 
   /** \brief Helper class for Serialization
+
+      Reads both the default text format and the binary format
+      (detected from the header). In the binary format, arrays of integers and
+      doubles are stored contiguously, 8-byte aligned relative to the start of the
+      stream, and are read with a single copy.
+
       \author Joris Gillis
       \date 2018
   */
@@ -97,6 +103,8 @@ namespace casadi {
     void unpack(std::string& e);
     void unpack(double& e);
     void unpack(char& e);
+    void unpack(std::vector<casadi_int>& e);
+    void unpack(std::vector<double>& e);
     template <class T>
     void unpack(std::vector<T>& e) {
       assert_decoration('V');
@@ -181,6 +189,12 @@ namespace casadi {
      */
     void assert_decoration(char e);
 
+    /// Read n bytes
+    void unpack_bytes(char* c, size_t n);
+
+    /// Read an array of 8-byte elements, aligned in binary mode
+    void unpack_array(char* c, size_t n);
+
     /// Collection of all shared pointer deserialized so far
     std::vector<UniversalNodeOwner> nodes_;
     std::unordered_map<void*, casadi_int>* shared_map_ = nullptr;
@@ -188,10 +202,16 @@ namespace casadi {
     std::istream& in;
     /// Debug mode?
     bool debug_;
+    /// Binary format?
+    bool binary_;
+    /// Number of bytes read (binary format)
+    size_t pos_;
   };
 
   /** \brief Helper class for Serialization
 
+      Options: "debug" (bool) adds type decorations,
+      "binary" (bool) writes raw bytes instead of the default text encoding.
 
       \author Joris Gillis
       \date 2018
@@ -225,6 +245,8 @@ namespace casadi {
     void pack(double e);
     void pack(const std::string& e);
     void pack(char e);
+    void pack(const std::vector<casadi_int>& e);
+    void pack(const std::vector<double>& e);
     template <class T>
     void pack(const std::vector<T>& e) {
       decorate('V');
@@ -270,6 +292,12 @@ namespace casadi {
      */
     void decorate(char e);
 
+    /// Write n bytes
+    void pack_bytes(const char* c, size_t n);
+
+    /// Write an array of 8-byte elements, aligned in binary mode
+    void pack_array(const char* c, size_t n);
+
     /* \brief Packs a shared object
     * 
     * Also treats SXNode, which is not actually a SharedObjectInternal
@@ -297,6 +325,10 @@ namespace casadi {
     std::ostream& out;
     /// Debug mode?
     bool debug_;
+    /// Binary format?
+    bool binary_;
+    /// Number of bytes written (binary format)
+    size_t pos_;
   };
 
   template <>
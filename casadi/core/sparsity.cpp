@@ -29,6 +29,7 @@
 #include "casadi_misc.hpp"
 #include "sparse_storage_impl.hpp"
 #include "serializing_stream.hpp"
+#include "sparsity_cache.hpp"
 #include <climits>
 
 #define CASADI_THROW_ERROR(FNAME, WHAT) \
@@ -726,20 +727,64 @@ namespace casadi {
     (*this)->get_nz(indices);
   }
 
+  // Key of a coloring in the on-disk cache, empty if not to be cached
+  static std::string coloring_cache_key(const Sparsity& sp, const std::string& alg,
+                                        casadi_int ordering, casadi_int cutoff) {
+    if (!SparsityCache::enabled() || sp.nnz()<SparsityCache::min_size) return std::string();
+    return alg + ";" + str(ordering) + ";" + str(cutoff) + ";" + sp.serialize();
+  }
+
   Sparsity Sparsity::uni_coloring(const Sparsity& AT, casadi_int cutoff) const {
+    std::string key = coloring_cache_key(*this, "uni_coloring", 0, cutoff);
+    Sparsity ret;
+    if (!key.empty() && SparsityCache::load(key, ret)) return ret;
+    if (AT.is_null()) {
+      ret = (*this)->uni_coloring(T(), cutoff);
+    } else {
+      ret = (*this)->uni_coloring(AT, cutoff);
+    }
+    if (!key.empty()) SparsityCache::store(key, ret);
+    return ret;
+  }
+
+  Sparsity Sparsity::jp_coloring(const Sparsity& AT, casadi_int cutoff) const {
+    std::string key = coloring_cache_key(*this, "jp_coloring", 0, cutoff);
+    Sparsity ret;
+    if (!key.empty() && SparsityCache::load(key, ret)) return ret;
     if (AT.is_null()) {
-      return (*this)->uni_coloring(T(), cutoff);
+      ret = (*this)->jp_coloring(T(), cutoff);
     } else {
-      return (*this)->uni_coloring(AT, cutoff);
+      ret = (*this)->jp_coloring(AT, cutoff);
+    }
+    if (!key.empty()) SparsityCache::store(key, ret);
+    return ret;
+  }
+
+  Sparsity Sparsity::recolor(const Sparsity& coloring, casadi_int n_pass,
+                             const Sparsity& AT) const {
+    if (AT.is_null()) {
+      return (*this)->recolor(T(), coloring, n_pass);
+    } else {
+      return (*this)->recolor(AT, coloring, n_pass);
     }
   }
 
   Sparsity Sparsity::star_coloring(casadi_int ordering, casadi_int cutoff) const {
-    return (*this)->star_coloring(ordering, cutoff);
+    std::string key = coloring_cache_key(*this, "star_coloring", ordering, cutoff);
+    Sparsity ret;
+    if (!key.empty() && SparsityCache::load(key, ret)) return ret;
+    ret = (*this)->star_coloring(ordering, cutoff);
+    if (!key.empty()) SparsityCache::store(key, ret);
+    return ret;
   }
 
   Sparsity Sparsity::star_coloring2(casadi_int ordering, casadi_int cutoff) const {
-    return (*this)->star_coloring2(ordering, cutoff);
+    std::string key = coloring_cache_key(*this, "star_coloring2", ordering, cutoff);
+    Sparsity ret;
+    if (!key.empty() && SparsityCache::load(key, ret)) return ret;
+    ret = (*this)->star_coloring2(ordering, cutoff);
+    if (!key.empty()) SparsityCache::store(key, ret);
+    return ret;
   }
 
   std::vector<casadi_int> Sparsity::largest_first() const {
@@ -800,6 +800,27 @@ namespace casadi {
     Sparsity uni_coloring(const Sparsity& AT=Sparsity(),
                           casadi_int cutoff = std::numeric_limits<casadi_int>::max()) const;
 
+    /** \brief Perform a unidirectional coloring in parallel: Jones-Plassmann distance-2 coloring
+        In each round, the uncolored columns with the largest (pseudo-random) priority among
+        their uncolored distance-2 neighbors are colored, in parallel in the thread pool.
+        The result does not depend on the number of threads.
+        A distance-2 coloring of a symmetric matrix is also a star coloring.
+
+          A Parallel Graph Coloring Heuristic
+          M. T. JONES, P. E. PLASSMANN
+          SIAM J. SCI. COMPUT. Vol. 14, No. 3, pp. 654–669 (1993)
+    */
+    Sparsity jp_coloring(const Sparsity& AT=Sparsity(),
+                         casadi_int cutoff = std::numeric_limits<casadi_int>::max()) const;
+
+    /** \brief Reduce the number of colors of a unidirectional coloring
+        Iterated greedy recoloring (Culberson): the columns are recolored greedily, visiting
+        the color classes in reverse order, and by decreasing size every other pass.
+        Does not increase the number of colors of a valid distance-2 coloring.
+    */
+    Sparsity recolor(const Sparsity& coloring, casadi_int n_pass=1,
+                     const Sparsity& AT=Sparsity()) const;
+
     /** \brief Perform a star coloring of a symmetric matrix:
         A greedy distance-2 coloring algorithm
         Algorithm 4.1 in
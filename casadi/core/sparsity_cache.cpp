@@ -0,0 +1,106 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+#include "sparsity_cache.hpp"
+#include "global_options.hpp"
+#include "serializing_stream.hpp"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+
+using namespace std;
+
+namespace casadi {
+
+  const casadi_int SparsityCache::min_size;
+
+  bool SparsityCache::enabled() {
+    return !GlobalOptions::sparsity_cache_dir.empty();
+  }
+
+  unsigned long long SparsityCache::hash(const std::string& key, unsigned long long basis) {
+    unsigned long long h = basis;
+    for (char c : key) {
+      h ^= static_cast<unsigned char>(c);
+      h *= 1099511628211ULL;
+    }
+    return h;
+  }
+
+  // File name of an entry
+  static std::string cache_file(const std::string& key) {
+    std::stringstream ss;
+    ss << GlobalOptions::sparsity_cache_dir << "/" << std::hex << std::setw(16)
+       << std::setfill('0') << SparsityCache::hash(key, 14695981039346656037ULL) << ".casadi_sp";
+    return ss.str();
+  }
+
+  // Second hash, with a different basis, stored in the file
+  static casadi_int cache_check(const std::string& key) {
+    return static_cast<casadi_int>(SparsityCache::hash(key, 0x6a09e667f3bcc909ULL));
+  }
+
+  bool SparsityCache::load(const std::string& key, Sparsity& sp) {
+    std::ifstream in(cache_file(key), std::ios::binary);
+    if (!in.good()) return false;
+    try {
+      DeserializingStream s(in);
+      s.version("SparsityCache", 1);
+      casadi_int len, check;
+      s.unpack("SparsityCache::len", len);
+      s.unpack("SparsityCache::check", check);
+      if (len!=static_cast<casadi_int>(key.size()) || check!=cache_check(key)) return false;
+      s.unpack("SparsityCache::sparsity", sp);
+      return true;
+    } catch (std::exception&) {
+      // Corrupt or incompatible entry, recompute
+      return false;
+    }
+  }
+
+  void SparsityCache::store(const std::string& key, const Sparsity& sp) {
+    std::string fname = cache_file(key);
+    // Write to a temporary file first, so that concurrent processes never read partial entries
+    std::string tmp = fname + "." +
+      str(std::chrono::steady_clock::now().time_since_epoch().count()) + ".tmp";
+    {
+      std::ofstream out(tmp, std::ios::binary);
+      if (!out.good()) {
+        casadi_warning("Cannot write to sparsity cache directory '"
+                       + GlobalOptions::sparsity_cache_dir + "'");
+        return;
+      }
+      SerializingStream s(out);
+      s.version("SparsityCache", 1);
+      s.pack("SparsityCache::len", static_cast<casadi_int>(key.size()));
+      s.pack("SparsityCache::check", cache_check(key));
+      s.pack("SparsityCache::sparsity", sp);
+    }
+    if (std::rename(tmp.c_str(), fname.c_str())) std::remove(tmp.c_str());
+  }
+
+} // namespace casadi
@@ -0,0 +1,68 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+#ifndef CASADI_SPARSITY_CACHE_HPP
+#define CASADI_SPARSITY_CACHE_HPP
+
+#include "sparsity.hpp"
+
+/// \cond INTERNAL
+
+namespace casadi {
+
+  /** \brief Persistent on-disk cache of sparsity patterns
+
+      Jacobian sparsity patterns and graph colorings are stored in
+      GlobalOptions::sparsity_cache_dir (disabled if empty), one file per entry.
+      Entries are content-addressed: the file name is a hash of a key string,
+      e.g. a hash of the serialized function (FunctionInternal::structure_hash)
+      and the requested block. The file also holds a second hash and the length
+      of the key to guard against collisions.
+      The pattern is stored with SerializingStream.
+  */
+  class CASADI_EXPORT SparsityCache {
+  public:
+    /// Smaller problems are recomputed rather than looked up
+    static const casadi_int min_size = 1000;
+
+    /// Is the cache enabled?
+    static bool enabled();
+
+    /// Look up a pattern, returns false if not in the cache
+    static bool load(const std::string& key, Sparsity& sp);
+
+    /// Store a pattern
+    static void store(const std::string& key, const Sparsity& sp);
+
+    /// 64-bit FNV-1a hash of a string
+    static unsigned long long hash(const std::string& key, unsigned long long basis);
+  };
+
+} // namespace casadi
+
+/// \endcond
+
+#endif // CASADI_SPARSITY_CACHE_HPP
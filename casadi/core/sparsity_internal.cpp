@@ -27,6 +27,7 @@
 #include "sparsity_internal.hpp"
 #include "casadi_misc.hpp"
 #include "global_options.hpp"
+#include "thread_pool.hpp"
 #include <climits>
 #include <cstdlib>
 #include <cmath>
@@ -2988,6 +2989,164 @@ namespace casadi {
 ;
   }
 
+  // Return sparsity containing a coloring, given the color of each column
+  static Sparsity coloring_sparsity(const vector<casadi_int>& color, casadi_int ncolor) {
+    vector<casadi_int> ret_colind(ncolor+1, 0), ret_row(color.size());
+    for (casadi_int c : color) ret_colind[c+1]++;
+    for (casadi_int j=0; j<ncolor; ++j) ret_colind[j+1] += ret_colind[j];
+    vector<casadi_int> pos(ret_colind.begin(), ret_colind.end()-1);
+    for (casadi_int j=0; j<color.size(); ++j) ret_row[pos[color[j]]++] = j;
+    return Sparsity(color.size(), ncolor, ret_colind, ret_row);
+  }
+
+  Sparsity SparsityInternal::jp_coloring(const Sparsity& AT, casadi_int cutoff) const {
+    casadi_int n = size2();
+
+    // Access the sparsity of the transpose
+    const casadi_int* AT_colind = AT.colind();
+    const casadi_int* AT_row = AT.row();
+    const casadi_int* colind = this->colind();
+    const casadi_int* row = this->row();
+
+    // Random priorities (splitmix64 of the index, so that the result is deterministic)
+    vector<unsigned long long> prio(n);
+    for (casadi_int i=0; i<n; ++i) {
+      unsigned long long z = static_cast<unsigned long long>(i) + 0x9e3779b97f4a7c15ULL;
+      z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+      z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+      prio[i] = z ^ (z >> 31);
+    }
+
+    // Color of each column, -1 if not yet colored
+    vector<casadi_int> color(n, -1);
+
+    // Columns not yet colored
+    vector<casadi_int> active = range(n);
+
+    // Is a column selected in the current round
+    vector<char> selected(n, 0);
+
+    // Number of colors used
+    casadi_int ncolor = 0;
+
+    ThreadPool& pool = ThreadPool::instance();
+    while (!active.empty()) {
+      casadi_int na = active.size();
+      // Number of blocks, small rounds are not split
+      casadi_int nb = std::min(std::max(na/256, casadi_int(1)), 4*(pool.n_workers()+1));
+
+      // Select the columns whose priority is largest among the uncolored distance-2 neighbors
+      pool.parallel_for(nb, [&](casadi_int b) {
+        for (casadi_int k=(b*na)/nb; k<((b+1)*na)/nb; ++k) {
+          casadi_int i = active[k];
+          bool is_max = true;
+          for (casadi_int el=colind[i]; el<colind[i+1] && is_max; ++el) {
+            casadi_int c = row[el];
+            for (casadi_int el2=AT_colind[c]; el2<AT_colind[c+1]; ++el2) {
+              casadi_int j = AT_row[el2];
+              if (j!=i && color[j]<0 && (prio[j]>prio[i] || (prio[j]==prio[i] && j>i))) {
+                is_max = false;
+                break;
+              }
+            }
+          }
+          selected[i] = is_max;
+        }
+      });
+
+      // The selected columns are not distance-2 neighbors: color them independently
+      vector<casadi_int> ncolor_b(nb, 0);
+      pool.parallel_for(nb, [&](casadi_int b) {
+        vector<casadi_int> forbiddenColors(ncolor+1, -1);
+        for (casadi_int k=(b*na)/nb; k<((b+1)*na)/nb; ++k) {
+          casadi_int i = active[k];
+          if (!selected[i]) continue;
+          // Mark the colors of the distance-2 neighbors as forbidden
+          for (casadi_int el=colind[i]; el<colind[i+1]; ++el) {
+            casadi_int c = row[el];
+            for (casadi_int el2=AT_colind[c]; el2<AT_colind[c+1]; ++el2) {
+              casadi_int color_j = color[AT_row[el2]];
+              if (color_j>=0) forbiddenColors[color_j] = i;
+            }
+          }
+          // Get the first nonforbidden color
+          casadi_int color_i = 0;
+          while (forbiddenColors[color_i]==i) color_i++;
+          color[i] = color_i;
+          ncolor_b[b] = std::max(ncolor_b[b], color_i+1);
+        }
+      });
+      for (casadi_int b=0; b<nb; ++b) ncolor = std::max(ncolor, ncolor_b[b]);
+
+      // Cutoff if too many colors
+      if (ncolor>cutoff) return Sparsity();
+
+      // Remove the colored columns
+      casadi_int na_new = 0;
+      for (casadi_int i : active) {
+        if (color[i]<0) active[na_new++] = i;
+      }
+      active.resize(na_new);
+    }
+
+    // Return the coloring
+    return coloring_sparsity(color, ncolor);
+  }
+
+  Sparsity SparsityInternal::recolor(const Sparsity& AT, const Sparsity& coloring,
+                                     casadi_int n_pass) const {
+    casadi_assert(coloring.size1()==size2(), "Coloring does not match the pattern");
+    casadi_int n = size2();
+
+    // Access the sparsity of the transpose
+    const casadi_int* AT_colind = AT.colind();
+    const casadi_int* AT_row = AT.row();
+    const casadi_int* colind = this->colind();
+    const casadi_int* row = this->row();
+
+    Sparsity ret = coloring;
+    vector<casadi_int> color(n), forbiddenColors, order, classes;
+    for (casadi_int pass=0; pass<n_pass; ++pass) {
+      casadi_int ncolor = ret.size2();
+      const casadi_int* c_colind = ret.colind();
+      const casadi_int* c_row = ret.row();
+
+      // Visit the color classes in reverse order, every other pass by decreasing size
+      classes = range(ncolor);
+      std::reverse(classes.begin(), classes.end());
+      if (pass % 2) {
+        std::stable_sort(classes.begin(), classes.end(), [&](casadi_int a, casadi_int b) {
+          return c_colind[a+1]-c_colind[a] > c_colind[b+1]-c_colind[b];});
+      }
+      order.clear();
+      for (casadi_int c : classes) {
+        order.insert(order.end(), c_row+c_colind[c], c_row+c_colind[c+1]);
+      }
+
+      // Greedy coloring in this order, uses at most ncolor colors for a valid input
+      std::fill(color.begin(), color.end(), -1);
+      forbiddenColors.assign(ncolor, -1);
+      casadi_int ncolor_new = 0;
+      for (casadi_int i : order) {
+        for (casadi_int el=colind[i]; el<colind[i+1]; ++el) {
+          casadi_int c = row[el];
+          for (casadi_int el2=AT_colind[c]; el2<AT_colind[c+1]; ++el2) {
+            casadi_int color_j = color[AT_row[el2]];
+            if (color_j>=0) forbiddenColors[color_j] = i;
+          }
+        }
+        casadi_int color_i = 0;
+        while (color_i<forbiddenColors.size() && forbiddenColors[color_i]==i) color_i++;
+        // Only if the given coloring was not a valid distance-2 coloring
+        if (color_i==forbiddenColors.size()) forbiddenColors.push_back(-1);
+        color[i] = color_i;
+        ncolor_new = std::max(ncolor_new, color_i+1);
+      }
+      ret = coloring_sparsity(color, ncolor_new);
+    }
+    return ret;
+  }
+
   Sparsity SparsityInternal::star_coloring2(casadi_int ordering, casadi_int cutoff) const {
     if (!is_square()) {
       // NOTE(@jaeandersson) Why warning and not error?
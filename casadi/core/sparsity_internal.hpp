@@ -589,6 +589,16 @@ namespace casadi {
      */
     Sparsity uni_coloring(const Sparsity& AT, casadi_int cutoff) const;
 
+    /** \brief Perform a unidirectional coloring in parallel
+     * See description in public class.
+     */
+    Sparsity jp_coloring(const Sparsity& AT, casadi_int cutoff) const;
+
+    /** \brief Reduce the number of colors of a unidirectional coloring
+     * See description in public class.
+     */
+    Sparsity recolor(const Sparsity& AT, const Sparsity& coloring, casadi_int n_pass) const;
+
     /** \brief A greedy distance-2 coloring algorithm
      * See description in public class.
      */
@@ -27,9 +27,12 @@
 #include <limits>
 #include <stack>
 #include <deque>
+#include <queue>
+#include <tuple>
 #include <fstream>
 #include <sstream>
 #include <iomanip>
+#include <cstring>
 #include "casadi_misc.hpp"
 #include "sx_node.hpp"
 #include "casadi_common.hpp"
@@ -37,6 +40,7 @@
 #include "global_options.hpp"
 #include "casadi_interrupt.hpp"
 #include "serializing_stream.hpp"
+#include "importer_internal.hpp"
 
 namespace casadi {
 
@@ -71,6 +75,9 @@ namespace casadi {
                    + str(free_vars_) + " are free.");
     }
 
+    // Threaded-code interpreter
+    if (threaded_code_) return eval_threaded(arg, res, w);
+
     // NOTE: The implementation of this function is very delicate. Small changes in the
     // class structure can cause large performance losses. For this reason,
     // the preprocessor macros are used below
@@ -90,6 +97,286 @@ namespace casadi {
     return 0;
   }
 
+  int SXFunction::eval_float(const float** arg, float** res,
+      casadi_int* iw, float* w, void* mem) const {
+    if (verbose_) casadi_message(name_ + "::eval_float");
+    casadi_assert(free_vars_.empty(), "Cannot evaluate \"" + name_ + "\" since variables "
+                  + str(free_vars_) + " are free.");
+
+    // Evaluate the algorithm, all operations in single precision
+    for (auto&& e : algorithm_) {
+      switch (e.op) {
+        CASADI_MATH_FUN_BUILTIN(w[e.i1], w[e.i2], w[e.i0])
+
+      case OP_CONST: w[e.i0] = static_cast<float>(e.d); break;
+      case OP_INPUT: w[e.i0] = arg[e.i1]==nullptr ? 0 : arg[e.i1][e.i2]; break;
+      case OP_OUTPUT: if (res[e.i0]!=nullptr) res[e.i0][e.i2] = w[e.i1]; break;
+      default:
+        casadi_error("Unknown operation" + str(e.op));
+      }
+    }
+    return 0;
+  }
+
+  /// Instructions of the threaded-code virtual machine
+  enum ThreadedOp {
+    TC_END, TC_CONST, TC_INPUT, TC_OUTPUT,
+    TC_ADD, TC_SUB, TC_MUL, TC_DIV,
+    TC_ADD_C, TC_SUB_C, TC_C_SUB, TC_MUL_C, TC_DIV_C, TC_C_DIV,
+    TC_MUL_ADD,
+    TC_NEG, TC_SQ, TC_TWICE, TC_SQRT, TC_EXP, TC_LOG, TC_SIN, TC_COS, TC_INV,
+    TC_GENERIC
+  };
+
+// Dispatch using computed goto (GCC extension) or a switch statement otherwise
+#if defined(__GNUC__)
+#define CASADI_TC_CASE(I) L_##I:
+#define CASADI_TC_NEXT goto *labels[(++e)->op]
+#else // __GNUC__
+#define CASADI_TC_CASE(I) case I:
+#define CASADI_TC_NEXT ++e; continue
+#endif // __GNUC__
+
+  int SXFunction::eval_threaded(const double** arg, double** res, double* w) const {
+    const ThreadedAtomic* e = threaded_.data();
+#if defined(__GNUC__)
+    // Jump table, must match the order of ThreadedOp
+    static const void* const labels[] = {
+      &&L_TC_END, &&L_TC_CONST, &&L_TC_INPUT, &&L_TC_OUTPUT,
+      &&L_TC_ADD, &&L_TC_SUB, &&L_TC_MUL, &&L_TC_DIV,
+      &&L_TC_ADD_C, &&L_TC_SUB_C, &&L_TC_C_SUB, &&L_TC_MUL_C, &&L_TC_DIV_C, &&L_TC_C_DIV,
+      &&L_TC_MUL_ADD,
+      &&L_TC_NEG, &&L_TC_SQ, &&L_TC_TWICE, &&L_TC_SQRT, &&L_TC_EXP, &&L_TC_LOG,
+      &&L_TC_SIN, &&L_TC_COS, &&L_TC_INV,
+      &&L_TC_GENERIC};
+    goto *labels[e->op];
+#else // __GNUC__
+    for (;;) switch (e->op) {
+#endif // __GNUC__
+    CASADI_TC_CASE(TC_CONST) w[e->i0] = e->d; CASADI_TC_NEXT;
+    CASADI_TC_CASE(TC_INPUT) w[e->i0] = arg[e->i1]==nullptr ? 0 : arg[e->i1][e->i2];
+      CASADI_TC_NEXT;
+    CASADI_TC_CASE(TC_OUTPUT) if (res[e->i0]!=nullptr) res[e->i0][e->i2] = w[e->i1];
+      CASADI_TC_NEXT;
+    CASADI_TC_CASE(TC_ADD) BinaryOperation<OP_ADD>::fcn(w[e->i1], w[e->i2], w[e->i0]);
+      CASADI_TC_NEXT;
+    CASADI_TC_CASE(TC_SUB) BinaryOperation<OP_SUB>::fcn(w[e->i1], w[e->i2], w[e->i0]);
+      CASADI_TC_NEXT;
+    CASADI_TC_CASE(TC_MUL) BinaryOperation<OP_MUL>::fcn(w[e->i1], w[e->i2], w[e->i0]);
+      CASADI_TC_NEXT;
+    CASADI_TC_CASE(TC_DIV) BinaryOperation<OP_DIV>::fcn(w[e->i1], w[e->i2], w[e->i0]);
+      CASADI_TC_NEXT;
+    CASADI_TC_CASE(TC_ADD_C) BinaryOperation<OP_ADD>::fcn(w[e->i1], e->d, w[e->i0]);
+      CASADI_TC_NEXT;
+    CASADI_TC_CASE(TC_SUB_C) BinaryOperation<OP_SUB>::fcn(w[e->i1], e->d, w[e->i0]);
+      CASADI_TC_NEXT;
+    CASADI_TC_CASE(TC_C_SUB) BinaryOperation<OP_SUB>::fcn(e->d, w[e->i1], w[e->i0]);
+      CASADI_TC_NEXT;
+    CASADI_TC_CASE(TC_MUL_C) BinaryOperation<OP_MUL>::fcn(w[e->i1], e->d, w[e->i0]);
+      CASADI_TC_NEXT;
+    CASADI_TC_CASE(TC_DIV_C) BinaryOperation<OP_DIV>::fcn(w[e->i1], e->d, w[e->i0]);
+      CASADI_TC_NEXT;
+    CASADI_TC_CASE(TC_C_DIV) BinaryOperation<OP_DIV>::fcn(e->d, w[e->i1], w[e->i0]);
+      CASADI_TC_NEXT;
+    CASADI_TC_CASE(TC_MUL_ADD) {
+        // Rounded product followed by rounded sum, not a hardware FMA, to keep
+        // the results identical to the switch-based interpreter
+        double p;
+        BinaryOperation<OP_MUL>::fcn(w[e->i1], w[e->i2], p);
+        BinaryOperation<OP_ADD>::fcn(p, w[e->i3], w[e->i0]);
+      }
+      CASADI_TC_NEXT;
+    CASADI_TC_CASE(TC_NEG) UnaryOperation<OP_NEG>::fcn(w[e->i1], w[e->i0]); CASADI_TC_NEXT;
+    CASADI_TC_CASE(TC_SQ) UnaryOperation<OP_SQ>::fcn(w[e->i1], w[e->i0]); CASADI_TC_NEXT;
+    CASADI_TC_CASE(TC_TWICE) UnaryOperation<OP_TWICE>::fcn(w[e->i1], w[e->i0]); CASADI_TC_NEXT;
+    CASADI_TC_CASE(TC_SQRT) UnaryOperation<OP_SQRT>::fcn(w[e->i1], w[e->i0]); CASADI_TC_NEXT;
+    CASADI_TC_CASE(TC_EXP) UnaryOperation<OP_EXP>::fcn(w[e->i1], w[e->i0]); CASADI_TC_NEXT;
+    CASADI_TC_CASE(TC_LOG) UnaryOperation<OP_LOG>::fcn(w[e->i1], w[e->i0]); CASADI_TC_NEXT;
+    CASADI_TC_CASE(TC_SIN) UnaryOperation<OP_SIN>::fcn(w[e->i1], w[e->i0]); CASADI_TC_NEXT;
+    CASADI_TC_CASE(TC_COS) UnaryOperation<OP_COS>::fcn(w[e->i1], w[e->i0]); CASADI_TC_NEXT;
+    CASADI_TC_CASE(TC_INV) UnaryOperation<OP_INV>::fcn(w[e->i1], w[e->i0]); CASADI_TC_NEXT;
+    CASADI_TC_CASE(TC_GENERIC)
+      // Less frequent operations, dispatched by the operator index in i3
+      casadi_math<double>::fun(e->i3, w[e->i1], w[e->i2], w[e->i0]);
+      CASADI_TC_NEXT;
+    CASADI_TC_CASE(TC_END) return 0;
+#if !defined(__GNUC__)
+    }
+#endif // __GNUC__
+  }
+
+#undef CASADI_TC_CASE
+#undef CASADI_TC_NEXT
+
+  void SXFunction::init_threaded() {
+    casadi_int n = algorithm_.size();
+
+    // Instruction that last wrote to each work vector element
+    vector<casadi_int> prod(worksize_, -1);
+    // Instructions producing the first and second operand of each instruction
+    vector<casadi_int> src1(n, -1), src2(n, -1);
+    // Number of times the result of each instruction is read
+    vector<casadi_int> nreads(n, 0);
+    for (casadi_int k=0; k<n; ++k) {
+      const AlgEl& e = algorithm_[k];
+      if (e.op==OP_OUTPUT) {
+        src1[k] = prod[e.i1];
+        nreads[src1[k]]++;
+        continue;
+      }
+      casadi_int ndeps = e.op==OP_INPUT ? 0 : casadi_math<double>::ndeps(e.op);
+      if (ndeps>=1) nreads[src1[k] = prod[e.i1]]++;
+      if (ndeps==2) nreads[src2[k] = prod[e.i2]]++;
+      prod[e.i0] = k;
+    }
+
+    // Fold constant operands of the basic arithmetic operations into immediates
+    // imm is 1 if the first operand is folded, 2 if the second operand is folded
+    vector<char> imm(n, 0);
+    vector<casadi_int> nfolded(n, 0);
+    for (casadi_int k=0; k<n; ++k) {
+      const AlgEl& e = algorithm_[k];
+      if (e.op==OP_ADD || e.op==OP_SUB || e.op==OP_MUL || e.op==OP_DIV) {
+        bool c1 = algorithm_[src1[k]].op==OP_CONST;
+        bool c2 = algorithm_[src2[k]].op==OP_CONST;
+        if (c1 && !c2) {
+          imm[k] = 1;
+          nfolded[src1[k]]++;
+        } else if (c2 && !c1) {
+          imm[k] = 2;
+          nfolded[src2[k]]++;
+        }
+      }
+    }
+
+    // Constants that are no longer needed in the work vector
+    vector<bool> skip(n, false);
+    for (casadi_int k=0; k<n; ++k) {
+      if (algorithm_[k].op==OP_CONST && nreads[k]>0 && nfolded[k]==nreads[k]) skip[k] = true;
+    }
+
+    // Generate instructions
+    threaded_.clear();
+    threaded_.reserve(n+1);
+    for (casadi_int k=0; k<n; ++k) {
+      if (skip[k]) continue;
+      const AlgEl& e = algorithm_[k];
+      ThreadedAtomic t;
+      t.i0 = e.i0;
+      t.i1 = e.i1;
+      t.i2 = e.i2;
+      t.i3 = 0;
+      t.d = 0;
+      switch (e.op) {
+      case OP_CONST: t.op = TC_CONST; t.d = e.d; break;
+      case OP_INPUT: t.op = TC_INPUT; break;
+      case OP_OUTPUT: t.op = TC_OUTPUT; break;
+      case OP_ADD:
+      case OP_SUB:
+      case OP_MUL:
+      case OP_DIV:
+        if (imm[k]) {
+          // Immediate operand, keep the variable operand in i1
+          bool first = imm[k]==1;
+          t.d = algorithm_[first ? src1[k] : src2[k]].d;
+          if (first) t.i1 = e.i2;
+          switch (e.op) {
+          case OP_ADD: t.op = TC_ADD_C; break;
+          case OP_SUB: t.op = first ? TC_C_SUB : TC_SUB_C; break;
+          case OP_MUL: t.op = TC_MUL_C; break;
+          default: t.op = first ? TC_C_DIV : TC_DIV_C;
+          }
+        } else if (e.op==OP_MUL && nreads[k]==1) {
+          // Product that is only used once: try to fuse with a subsequent addition
+          casadi_int k2 = k+1;
+          while (k2<n && skip[k2]) k2++;
+          if (k2<n && algorithm_[k2].op==OP_ADD && !imm[k2]
+              && (src1[k2]==k || src2[k2]==k)) {
+            const AlgEl& e2 = algorithm_[k2];
+            t.op = TC_MUL_ADD;
+            t.i0 = e2.i0;
+            t.i3 = src1[k2]==k ? e2.i2 : e2.i1;
+            skip[k2] = true;
+          } else {
+            t.op = TC_MUL;
+          }
+        } else {
+          t.op = e.op==OP_ADD ? TC_ADD : e.op==OP_SUB ? TC_SUB : e.op==OP_MUL ? TC_MUL : TC_DIV;
+        }
+        break;
+      case OP_NEG: t.op = TC_NEG; break;
+      case OP_SQ: t.op = TC_SQ; break;
+      case OP_TWICE: t.op = TC_TWICE; break;
+      case OP_SQRT: t.op = TC_SQRT; break;
+      case OP_EXP: t.op = TC_EXP; break;
+      case OP_LOG: t.op = TC_LOG; break;
+      case OP_SIN: t.op = TC_SIN; break;
+      case OP_COS: t.op = TC_COS; break;
+      case OP_INV: t.op = TC_INV; break;
+      default:
+        t.op = TC_GENERIC;
+        t.i3 = e.op;
+      }
+      threaded_.push_back(t);
+    }
+
+    // Terminate
+    ThreadedAtomic t_end;
+    t_end.op = TC_END;
+    t_end.i0 = t_end.i1 = t_end.i2 = t_end.i3 = 0;
+    t_end.d = 0;
+    threaded_.push_back(t_end);
+
+    if (verbose_) casadi_message("Threaded code: " + str(threaded_.size()-1)
+      + " instructions instead of " + str(n));
+  }
+
+  int SXFunction::eval_simd(const double** arg, double** res, double* w,
+      casadi_int n) const {
+    if (verbose_) casadi_message(name_ + "::eval_simd");
+
+    // Make sure no free parameters
+    if (!free_vars_.empty()) {
+      std::stringstream ss;
+      disp(ss, false);
+      casadi_error("Cannot evaluate \"" + ss.str() + "\" since variables "
+                   + str(free_vars_) + " are free.");
+    }
+
+    // Each work vector element occupies n consecutive entries, one for each instance,
+    // so that every dispatch below handles a contiguous block of n lanes
+    for (auto&& e : algorithm_) {
+      switch (e.op) {
+        CASADI_MATH_FUN_BUILTIN_GEN(BinaryOperationVV, w+e.i1*n, w+e.i2*n, w+e.i0*n, n)
+
+      case OP_CONST:
+        std::fill_n(w+e.i0*n, n, e.d);
+        break;
+      case OP_INPUT:
+        if (arg[e.i1]==nullptr) {
+          std::fill_n(w+e.i0*n, n, 0.);
+        } else {
+          casadi_int stride = nnz_in(e.i1);
+          const double* a = arg[e.i1] + e.i2;
+          double* r = w+e.i0*n;
+          for (casadi_int k=0; k<n; ++k) r[k] = a[k*stride];
+        }
+        break;
+      case OP_OUTPUT:
+        if (res[e.i0]!=nullptr) {
+          casadi_int stride = nnz_out(e.i0);
+          double* r = res[e.i0] + e.i2;
+          const double* a = w+e.i1*n;
+          for (casadi_int k=0; k<n; ++k) r[k*stride] = a[k];
+        }
+        break;
+      default:
+        casadi_error("Unknown operation" + str(e.op));
+      }
+    }
+    return 0;
+  }
+
   bool SXFunction::is_smooth() const {
     // Go through all nodes and check if any node is non-smooth
     for (auto&& a : algorithm_) {
@@ -151,12 +438,27 @@ namespace casadi {
   }
 
   void SXFunction::codegen_body(CodeGenerator& g) const {
+    casadi_int n = algorithm_.size();
+    if (g.chunk_size>0 && n>g.chunk_size && !g.simd_kernel_) {
+      // Split into chunks in separate files, passing the work vector between them
+      for (casadi_int k=0; k<n; k+=g.chunk_size) {
+        std::string fname = g.chunk_begin();
+        codegen_range(g, k, std::min(k+g.chunk_size, n));
+        g.chunk_end();
+        g << fname << "(arg, res, w);\n";
+      }
+    } else {
+      codegen_range(g, 0, n);
+    }
+  }
 
+  void SXFunction::codegen_range(CodeGenerator& g, casadi_int k0, casadi_int k1) const {
     // Run the algorithm
-    for (auto&& a : algorithm_) {
+    for (casadi_int k=k0; k<k1; ++k) {
+      const AlgEl& a = algorithm_[k];
       if (a.op==OP_OUTPUT) {
         g << "if (res[" << a.i0 << "]!=0) "
-          << g.res(a.i0) << "[" << a.i2 << "]=" << g.sx_work(a.i1);
+          << g.io_nz(g.res(a.i0), a.i2) << "=" << g.sx_work(a.i1);
       } else {
 
         // Where to store the result
@@ -166,7 +468,7 @@ namespace casadi {
         if (a.op==OP_CONST) {
           g << g.constant(a.d);
         } else if (a.op==OP_INPUT) {
-          g << g.arg(a.i1) << "? " << g.arg(a.i1) << "[" << a.i2 << "] : 0";
+          g << g.arg(a.i1) << "? " << g.io_nz(g.arg(a.i1), a.i2) << " : 0";
         } else {
           casadi_int ndep = casadi_math<double>::ndeps(a.op);
           casadi_assert_dev(ndep>0);
@@ -178,6 +480,161 @@ namespace casadi {
     }
   }
 
+  void SXFunction::codegen_simd(CodeGenerator& g, const std::string& fname) const {
+    // Kernel for instance k out of n, vectorized by the compiler across instances
+    g << "/* " << definition() << ", instance k of n */\n"
+      << "#pragma omp declare simd uniform(arg, res, n) linear(k:1)\n"
+      << "static void " << fname << "_simd(const casadi_real** arg, casadi_real** res, "
+      << "casadi_int n, casadi_int k) {\n";
+    g.flush(g.body);
+    g.scope_enter();
+    g.simd_kernel_ = true;
+    codegen_body(g);
+    g.simd_kernel_ = false;
+    g.scope_exit();
+    g << "}\n\n";
+    g.flush(g.body);
+
+    // Loop over instances, structure of arrays layout
+    g << g.declare("int " + name_ + "_simd(const casadi_real** arg, casadi_real** res, "
+                   "casadi_int n, casadi_int* iw, casadi_real* w, int mem)") << " {\n"
+      << "casadi_int k;\n"
+      << "#pragma omp simd\n"
+      << "for (k=0; k<n; ++k) " << fname << "_simd(arg, res, n, k);\n"
+      << "return 0;\n"
+      << "}\n\n";
+  }
+
+  /// Evaluate an operation not inlined in the machine code (called from generated code)
+  static double native_fun(double x, double y, int op) {
+    double f;
+    casadi_math<double>::fun(op, x, y, f);
+    return f;
+  }
+
+  /// Minimal x86-64 assembler for the SXFunction machine code generator
+  struct X64Assembler {
+    std::vector<unsigned char> c;
+    void b(std::initializer_list<unsigned char> v) { c.insert(c.end(), v); }
+    void i32(casadi_int v) {
+      casadi_assert(v>=std::numeric_limits<int32_t>::min()
+        && v<=std::numeric_limits<int32_t>::max(), "Displacement out of range");
+      int32_t v32 = static_cast<int32_t>(v);
+      const unsigned char* p = reinterpret_cast<const unsigned char*>(&v32);
+      c.insert(c.end(), p, p+4);
+    }
+    void i64(uint64_t v) {
+      const unsigned char* p = reinterpret_cast<const unsigned char*>(&v);
+      c.insert(c.end(), p, p+8);
+    }
+    // movsd xmm0/xmm1, [r13+8*i]
+    void load_w(int xmm, casadi_int i) { b({0xF2, 0x41, 0x0F, 0x10,
+      static_cast<unsigned char>(xmm==0 ? 0x85 : 0x8D)}); i32(8*i); }
+    // movsd [r13+8*i], xmm0
+    void store_w(casadi_int i) { b({0xF2, 0x41, 0x0F, 0x11, 0x85}); i32(8*i); }
+    // mov rax, imm64; movq xmm0/xmm1, rax
+    void load_const(int xmm, double d) {
+      uint64_t v;
+      std::memcpy(&v, &d, sizeof(v));
+      b({0x48, 0xB8}); i64(v);
+      b({0x66, 0x48, 0x0F, 0x6E, static_cast<unsigned char>(xmm==0 ? 0xC0 : 0xC8)});
+    }
+  };
+
+  bool SXFunction::has_native_code() const {
+#ifdef CASADI_WITH_NATIVE_JIT
+    return true;
+#else // CASADI_WITH_NATIVE_JIT
+    return false;
+#endif // CASADI_WITH_NATIVE_JIT
+  }
+
+  std::vector<unsigned char> SXFunction::native_code() const {
+    // Make sure that there are no free variables
+    if (!free_vars_.empty()) {
+      casadi_error("Machine code generation of '" + name_ + "' is not possible since variables "
+                   + str(free_vars_) + " are free.");
+    }
+    casadi_assert(has_native_code(), "Machine code generation requires x86-64 (System V ABI)");
+
+    // System V ABI: arg in rdi, res in rsi, iw in rdx, w in rcx
+    // Kept in callee-saved registers: arg in rbx, res in r14, w in r13
+    X64Assembler a;
+    a.b({0x53});               // push rbx
+    a.b({0x41, 0x55});         // push r13
+    a.b({0x41, 0x56});         // push r14 (stack is now 16-byte aligned for calls)
+    a.b({0x48, 0x89, 0xFB});   // mov rbx, rdi
+    a.b({0x49, 0x89, 0xF6});   // mov r14, rsi
+    a.b({0x49, 0x89, 0xCD});   // mov r13, rcx
+
+    // Work vector element currently held in xmm0, if any
+    casadi_int xmm0_w = -1;
+    for (auto&& e : algorithm_) {
+      switch (e.op) {
+      case OP_CONST:
+        a.load_const(0, e.d);
+        break;
+      case OP_INPUT:
+        a.b({0x48, 0x8B, 0x83}); a.i32(8*e.i1);  // mov rax, [rbx+8*i1]
+        a.b({0x48, 0x85, 0xC0});                 // test rax, rax
+        a.b({0x74, 0x0A});                       // je zero
+        a.b({0xF2, 0x0F, 0x10, 0x80}); a.i32(8*e.i2);  // movsd xmm0, [rax+8*i2]
+        a.b({0xEB, 0x04});                       // jmp done
+        a.b({0x66, 0x0F, 0x57, 0xC0});           // zero: xorpd xmm0, xmm0
+        break;                                   // done:
+      case OP_OUTPUT:
+        if (xmm0_w!=e.i1) a.load_w(0, e.i1);
+        a.b({0x49, 0x8B, 0x86}); a.i32(8*e.i0);  // mov rax, [r14+8*i0]
+        a.b({0x48, 0x85, 0xC0});                 // test rax, rax
+        a.b({0x74, 0x08});                       // je skip
+        a.b({0xF2, 0x0F, 0x11, 0x80}); a.i32(8*e.i2);  // movsd [rax+8*i2], xmm0
+        xmm0_w = e.i1;                           // skip:
+        continue;
+      default:
+        // Operands in xmm0 and xmm1, the work vector is always up to date
+        if (xmm0_w!=e.i1) a.load_w(0, e.i1);
+        if (casadi_math<double>::ndeps(e.op)==2) {
+          if (e.i2==e.i1) {
+            a.b({0x66, 0x0F, 0x28, 0xC8});       // movapd xmm1, xmm0
+          } else {
+            a.load_w(1, e.i2);
+          }
+        }
+        switch (e.op) {
+        case OP_ASSIGN: break;
+        case OP_ADD: a.b({0xF2, 0x0F, 0x58, 0xC1}); break;  // addsd xmm0, xmm1
+        case OP_SUB: a.b({0xF2, 0x0F, 0x5C, 0xC1}); break;  // subsd xmm0, xmm1
+        case OP_MUL: a.b({0xF2, 0x0F, 0x59, 0xC1}); break;  // mulsd xmm0, xmm1
+        case OP_DIV: a.b({0xF2, 0x0F, 0x5E, 0xC1}); break;  // divsd xmm0, xmm1
+        case OP_SQ: a.b({0xF2, 0x0F, 0x59, 0xC0}); break;   // mulsd xmm0, xmm0
+        case OP_TWICE: a.b({0xF2, 0x0F, 0x58, 0xC0}); break;  // addsd xmm0, xmm0
+        case OP_SQRT: a.b({0xF2, 0x0F, 0x51, 0xC0}); break;   // sqrtsd xmm0, xmm0
+        case OP_NEG:
+          a.b({0x66, 0x48, 0x0F, 0x7E, 0xC0});   // movq rax, xmm0
+          a.b({0x48, 0x0F, 0xBA, 0xF8, 0x3F});   // btc rax, 63
+          a.b({0x66, 0x48, 0x0F, 0x6E, 0xC0});   // movq xmm0, rax
+          break;
+        default:
+          // Call out, e.g. to libm for transcendental functions
+          if (casadi_math<double>::ndeps(e.op)==1) a.load_w(1, e.i2);
+          a.b({0xBF}); a.i32(e.op);              // mov edi, op
+          a.b({0x48, 0xB8});                     // mov rax, native_fun
+          a.i64(reinterpret_cast<uint64_t>(&native_fun));
+          a.b({0xFF, 0xD0});                     // call rax
+        }
+      }
+      a.store_w(e.i0);
+      xmm0_w = e.i0;
+    }
+
+    a.b({0x31, 0xC0});         // xor eax, eax
+    a.b({0x41, 0x5E});         // pop r14
+    a.b({0x41, 0x5D});         // pop r13
+    a.b({0x5B});               // pop rbx
+    a.b({0xC3});               // ret
+    return a.c;
+  }
+
   const Options SXFunction::options_
   = {{&FunctionInternal::options_},
      {{"default_in",
@@ -192,7 +649,19 @@ namespace casadi {
         "Just-in-time compilation for numeric evaluation using OpenCL (experimental)"}},
       {"live_variables",
        {OT_BOOL,
-        "Reuse variables in the work vector"}}
+        "Reuse variables in the work vector"}},
+      {"threaded_code",
+       {OT_BOOL,
+        "Evaluate numerically with a threaded-code interpreter using fused instructions "
+        "and immediate constant operands"}},
+      {"cse",
+       {OT_BOOL,
+        "Merge structurally identical subexpressions before sorting the graph"}},
+      {"schedule",
+       {OT_STRING,
+        "Order of the instructions: 'depth_first' (default) or 'min_live' "
+        "(list scheduling reducing the number of live variables and the distance "
+        "between definition and use)"}}
      }
   };
 
@@ -200,11 +669,216 @@ namespace casadi {
     Dict opts = FunctionInternal::generate_options(is_temp);
     //opts["default_in"] = default_in_;
     opts["live_variables"] = live_variables_;
+    opts["threaded_code"] = threaded_code_;
     opts["just_in_time_sparsity"] = just_in_time_sparsity_;
     opts["just_in_time_opencl"] = just_in_time_opencl_;
     return opts;
   }
 
+  /// Dependency graph of a sorted list of nodes, null pointers marking outputs
+  struct SXScheduleGraph {
+    // Dependencies of each position (-1 if none)
+    std::vector<casadi_int> dep0, dep1;
+    // Constants and symbolic primitives
+    std::vector<bool> leaf, output;
+    // Consumers of each position (compressed, one entry per use)
+    std::vector<casadi_int> cons_offset, cons;
+  };
+
+  /// Number of live variables at peak and mean distance between definition and use
+  static void sx_schedule_stats(const SXScheduleGraph& gr, const std::vector<casadi_int>& ord,
+                                casadi_int& peak, double& dist) {
+    casadi_int n = ord.size();
+    vector<casadi_int> rem(n), deftime(n, 0);
+    for (casadi_int i=0; i<n; ++i) rem[i] = gr.cons_offset[i+1]-gr.cons_offset[i];
+    casadi_int live = 0, n_use = 0;
+    double dist_sum = 0;
+    peak = 0;
+    for (casadi_int t=0; t<n; ++t) {
+      casadi_int i = ord[t];
+      for (casadi_int j : {gr.dep0[i], gr.dep1[i]}) {
+        if (j<0) continue;
+        dist_sum += t - deftime[j];
+        n_use++;
+        if (--rem[j]==0) live--;
+      }
+      if (!gr.output[i]) {
+        deftime[i] = t;
+        peak = std::max(peak, ++live);
+      }
+    }
+    dist = n_use==0 ? 0 : dist_sum/n_use;
+  }
+
+  void SXFunction::schedule_min_live(std::vector<SXNode*>& nodes) const {
+    casadi_int n = nodes.size();
+
+    // Position of each node
+    for (casadi_int i=0; i<n; ++i) if (nodes[i]) nodes[i]->temp = static_cast<int>(i);
+
+    // Nodes of the outputs, in order
+    vector<casadi_int> out_node;
+    for (auto&& e : out_) {
+      for (auto&& nz : e.nonzeros()) out_node.push_back(nz.get()->temp);
+    }
+
+    // Dependency graph
+    SXScheduleGraph gr;
+    gr.dep0.resize(n, -1);
+    gr.dep1.resize(n, -1);
+    gr.leaf.resize(n, false);
+    gr.output.resize(n, false);
+    vector<casadi_int> out_pos;
+    for (casadi_int i=0; i<n; ++i) {
+      SXNode* t = nodes[i];
+      if (t==nullptr) {
+        gr.output[i] = true;
+        gr.dep0[i] = out_node.at(out_pos.size());
+        out_pos.push_back(i);
+      } else if (t->is_constant() || t->is_symbolic()) {
+        gr.leaf[i] = true;
+      } else {
+        casadi_int ndeps = casadi_math<double>::ndeps(t->op());
+        gr.dep0[i] = t->dep(0).get()->temp;
+        if (ndeps==2) gr.dep1[i] = t->dep(1).get()->temp;
+      }
+    }
+    gr.cons_offset.resize(n+1, 0);
+    for (casadi_int i=0; i<n; ++i) {
+      for (casadi_int j : {gr.dep0[i], gr.dep1[i]}) if (j>=0) gr.cons_offset[j+1]++;
+    }
+    for (casadi_int i=0; i<n; ++i) gr.cons_offset[i+1] += gr.cons_offset[i];
+    gr.cons.resize(gr.cons_offset[n]);
+    vector<casadi_int> fill(gr.cons_offset.begin(), gr.cons_offset.end()-1);
+    for (casadi_int i=0; i<n; ++i) {
+      for (casadi_int j : {gr.dep0[i], gr.dep1[i]}) if (j>=0) gr.cons[fill[j]++] = i;
+    }
+
+    // Remaining uses of each node, pending non-leaf dependencies of each instruction
+    vector<casadi_int> rem(n), npend(n, 0), deftime(n, -1), version(n, 0);
+    for (casadi_int i=0; i<n; ++i) {
+      rem[i] = gr.cons_offset[i+1]-gr.cons_offset[i];
+      for (casadi_int j : {gr.dep0[i], gr.dep1[i]}) if (j>=0 && !gr.leaf[j]) npend[i]++;
+    }
+    vector<bool> done(n, false);
+
+    // Change in the number of live variables if instruction i is executed next
+    auto score = [&](casadi_int i) {
+      casadi_int s = 1;
+      casadi_int j0 = gr.dep0[i], j1 = gr.dep1[i];
+      for (casadi_int j : {j0, j1}) {
+        if (j<0) continue;
+        // Number of uses of j by this instruction
+        casadi_int cnt = j0==j1 ? 2 : 1;
+        if (done[j]) {
+          if (rem[j]==cnt) s--;
+        } else if (rem[j]>cnt) {
+          s++;
+        }
+        if (j0==j1) break;
+      }
+      return s;
+    };
+
+    // Most recent definition among the dependencies, for locality
+    auto recency = [&](casadi_int i) {
+      casadi_int r = -1;
+      for (casadi_int j : {gr.dep0[i], gr.dep1[i]}) {
+        if (j>=0 && !gr.leaf[j]) r = std::max(r, deftime[j]);
+      }
+      return r;
+    };
+
+    // Ready instructions: smallest score, then most recent operands, then original order
+    typedef std::tuple<casadi_int, casadi_int, casadi_int, casadi_int> Entry;
+    auto cmp = [](const Entry& a, const Entry& b) {
+      if (std::get<0>(a)!=std::get<0>(b)) return std::get<0>(a)>std::get<0>(b);
+      if (std::get<1>(a)!=std::get<1>(b)) return std::get<1>(a)<std::get<1>(b);
+      return std::get<2>(a)>std::get<2>(b);
+    };
+    std::priority_queue<Entry, vector<Entry>, decltype(cmp)> ready(cmp);
+    auto push = [&](casadi_int i) {
+      ready.push(Entry(score(i), recency(i), i, ++version[i]));
+    };
+
+    // New order
+    vector<casadi_int> ord;
+    ord.reserve(n);
+    auto emit = [&](casadi_int i) {
+      for (casadi_int j : {gr.dep0[i], gr.dep1[i]}) {
+        if (j<0) continue;
+        rem[j]--;
+        // Last uses of j are about to become free: update their consumers
+        if (rem[j]>0 && rem[j]<=2) {
+          for (casadi_int k=gr.cons_offset[j]; k<gr.cons_offset[j+1]; ++k) {
+            casadi_int c = gr.cons[k];
+            if (!done[c] && !gr.output[c] && npend[c]==0) push(c);
+          }
+        }
+      }
+      done[i] = true;
+      deftime[i] = ord.size();
+      ord.push_back(i);
+      if (gr.leaf[i]) return;
+      for (casadi_int k=gr.cons_offset[i]; k<gr.cons_offset[i+1]; ++k) {
+        casadi_int c = gr.cons[k];
+        if (--npend[c]==0 && !gr.output[c]) push(c);
+      }
+    };
+
+    // Leaves are placed just before their first use
+    auto emit_leaves = [&](casadi_int i) {
+      for (casadi_int j : {gr.dep0[i], gr.dep1[i]}) {
+        if (j>=0 && gr.leaf[j] && !done[j]) emit(j);
+      }
+    };
+
+    // Outputs are written in the original order, as soon as possible
+    casadi_int next_out = 0;
+    auto flush_outputs = [&]() {
+      while (next_out<out_pos.size()) {
+        casadi_int i = out_pos[next_out];
+        casadi_int j = gr.dep0[i];
+        if (!done[j] && !gr.leaf[j]) break;
+        emit_leaves(i);
+        emit(i);
+        next_out++;
+      }
+    };
+
+    for (casadi_int i=0; i<n; ++i) {
+      if (!gr.leaf[i] && !gr.output[i] && npend[i]==0) push(i);
+    }
+    flush_outputs();
+    while (!ready.empty()) {
+      Entry e = ready.top();
+      ready.pop();
+      casadi_int i = std::get<2>(e);
+      if (done[i] || std::get<3>(e)!=version[i]) continue;
+      emit_leaves(i);
+      emit(i);
+      flush_outputs();
+    }
+    casadi_assert(ord.size()==n, "Instruction scheduling failed");
+
+    // Report
+    if (verbose_) {
+      vector<casadi_int> ord0 = range(n);
+      casadi_int peak0, peak1;
+      double dist0, dist1;
+      sx_schedule_stats(gr, ord0, peak0, dist0);
+      sx_schedule_stats(gr, ord, peak1, dist1);
+      casadi_message("Instruction scheduling: at most " + str(peak1)
+        + " live variables instead of " + str(peak0)
+        + ", mean distance between definition and use "
+        + str(dist1) + " instead of " + str(dist0) + " instructions");
+    }
+
+    // Reorder nodes
+    vector<SXNode*> nodes0 = nodes;
+    for (casadi_int k=0; k<n; ++k) nodes[k] = nodes0[ord[k]];
+  }
+
   void SXFunction::init(const Dict& opts) {
     // Call the init function of the base class
     XFunction<SXFunction, SX, SXNode>::init(opts);
@@ -212,6 +886,9 @@ namespace casadi {
 
     // Default (temporary) options
     live_variables_ = true;
+    threaded_code_ = false;
+    bool cse = false;
+    std::string schedule = "depth_first";
 
     // Read options
     for (auto&& op : opts) {
@@ -219,12 +896,23 @@ namespace casadi {
         default_in_ = op.second;
       } else if (op.first=="live_variables") {
         live_variables_ = op.second;
+      } else if (op.first=="threaded_code") {
+        threaded_code_ = op.second;
       } else if (op.first=="just_in_time_opencl") {
         just_in_time_opencl_ = op.second;
       } else if (op.first=="just_in_time_sparsity") {
         just_in_time_sparsity_ = op.second;
+      } else if (op.first=="cse") {
+        cse = op.second;
+      } else if (op.first=="schedule") {
+        schedule = op.second.to_string();
       }
     }
+    casadi_assert(schedule=="depth_first" || schedule=="min_live",
+      "Option 'schedule' must be 'depth_first' or 'min_live', got '" + schedule + "'");
+
+    // Common subexpression elimination
+    if (cse) out_ = SX::cse(out_);
 
     // Check/set default inputs
     if (default_in_.empty()) {
@@ -254,6 +942,9 @@ namespace casadi {
       }
     }
 
+    // Reorder independent instructions to reduce the number of live variables
+    if (schedule=="min_live") schedule_min_live(nodes);
+
     casadi_assert(nodes.size() <= std::numeric_limits<int>::max(), "Integer overflow");
     // Set the temporary variables to be the corresponding place in the sorted graph
     for (casadi_int i=0; i<nodes.size(); ++i) {
@@ -460,6 +1151,9 @@ namespace casadi {
       }
     }
 
+    // Translate the algorithm for the threaded-code interpreter
+    if (threaded_code_) init_threaded();
+
     // Initialize just-in-time compilation for numeric evaluation using OpenCL
     if (just_in_time_opencl_) {
       casadi_error("OpenCL is not supported in this version of CasADi");
@@ -965,7 +1659,7 @@ namespace casadi {
 
   SXFunction::SXFunction(DeserializingStream& s) :
     XFunction<SXFunction, SX, SXNode>(s) {
-    s.version("SXFunction", 1);
+    int version = s.version("SXFunction", 1, 2);
     size_t n_instructions;
     s.unpack("SXFunction::n_instr", n_instructions);
 
@@ -989,13 +1683,19 @@ namespace casadi {
     just_in_time_sparsity_ = false;
 
     s.unpack("SXFunction::live_variables", live_variables_);
+    if (version==1) {
+      threaded_code_ = false;
+    } else {
+      s.unpack("SXFunction::threaded_code", threaded_code_);
+    }
+    if (threaded_code_) init_threaded();
 
     XFunction<SXFunction, SX, SXNode>::delayed_deserialize_members(s);
   }
 
   void SXFunction::serialize_body(SerializingStream &s) const {
     XFunction<SXFunction, SX, SXNode>::serialize_body(s);
-    s.version("SXFunction", 1);
+    s.version("SXFunction", 2);
     s.pack("SXFunction::n_instr", algorithm_.size());
 
     s.pack("SXFunction::worksize", worksize_);
@@ -1013,6 +1713,7 @@ namespace casadi {
     }
 
     s.pack("SXFunction::live_variables", live_variables_);
+    s.pack("SXFunction::threaded_code", threaded_code_);
 
     XFunction<SXFunction, SX, SXNode>::delayed_serialize_members(s);
   }
@@ -41,6 +41,16 @@ namespace casadi {
     };
   };
 
+  /** \brief  An atomic operation for the threaded-code SXElem virtual machine
+      Unlike ScalarAtomic, fused instructions may have a third operand and an
+      immediate (constant) operand at the same time
+  */
+  struct ThreadedAtomic {
+    int op;     /// Instruction index
+    int i0, i1, i2, i3;
+    double d;
+  };
+
 /** \brief  Internal node class for SXFunction
     Do not use any internal class directly - always use the public Function
     \author Joel Andersson
@@ -62,6 +72,20 @@ class CASADI_EXPORT SXFunction :
   /** \brief  Evaluate numerically, work vectors given */
   int eval(const double** arg, double** res, casadi_int* iw, double* w, void* mem) const override;
 
+  /** \brief  Evaluate numerically in single precision, work vectors given */
+  int eval_float(const float** arg, float** res, casadi_int* iw, float* w,
+    void* mem) const override;
+
+  /** \brief  Evaluate numerically for n instances at once (structure-of-arrays)
+
+      arg and res point to n consecutive instances of each input/output,
+      the work vector must hold sz_w()*n entries.
+  */
+  int eval_simd(const double** arg, double** res, double* w, casadi_int n) const;
+
+  /** \brief  Evaluate numerically using the threaded-code tape */
+  int eval_threaded(const double** arg, double** res, double* w) const;
+
   /** \brief  evaluate symbolically while also propagating directional derivatives */
   int eval_sx(const SXElem** arg, SXElem** res,
               casadi_int* iw, SXElem* w, void* mem) const override;
@@ -182,6 +206,15 @@ class CASADI_EXPORT SXFunction :
   /// Default input values
   std::vector<double> default_in_;
 
+  /// Compacted instructions for the threaded-code interpreter
+  std::vector<ThreadedAtomic> threaded_;
+
+  /// Translate the algorithm into threaded-code instructions
+  void init_threaded();
+
+  /** \brief Reorder sorted nodes to reduce the number of live variables */
+  void schedule_min_live(std::vector<SXNode*>& nodes) const;
+
     /** \brief Serialize an object without type information */
   void serialize_body(SerializingStream &s) const override;
 
@@ -206,6 +239,21 @@ class CASADI_EXPORT SXFunction :
   /** \brief Generate code for the body of the C function */
   void codegen_body(CodeGenerator& g) const override;
 
+  /** \brief Generate code for the instructions k0 to k1-1 */
+  void codegen_range(CodeGenerator& g, casadi_int k0, casadi_int k1) const;
+
+  /** \brief Is a batched (SIMD) entry point available? */
+  bool has_codegen_simd() const override { return true;}
+
+  /** \brief Generate a batched entry point, evaluating n instances at once */
+  void codegen_simd(CodeGenerator& g, const std::string& fname) const override;
+
+  /** \brief Is in-process machine code generation supported? */
+  bool has_native_code() const override;
+
+  /** \brief Generate x86-64 machine code for the numerical evaluation */
+  std::vector<unsigned char> native_code() const override;
+
   /** \brief  Propagate sparsity forward */
   int sp_forward(const bvec_t** arg, bvec_t** res,
                   casadi_int* iw, bvec_t* w, void* mem) const override;
@@ -238,6 +286,9 @@ class CASADI_EXPORT SXFunction :
   /// Live variables?
   bool live_variables_;
 
+  /// Evaluate using the threaded-code interpreter?
+  bool threaded_code_;
+
 protected:
   /** \brief Deserializing constructor */
   explicit SXFunction(DeserializingStream& s);
@@ -26,6 +26,8 @@
 #include "matrix_impl.hpp"
 
 #include "sx_function.hpp"
+#include <cstring>
+#include <unordered_map>
 
 using namespace std;
 
@@ -861,6 +863,99 @@ namespace casadi {
     copy(vdef.begin(), vdef.end(), vdef_sx.begin());
   }
 
+  // Hash key for an SX operation with canonical dependencies
+  struct SXOpKey {
+    casadi_int op;
+    const SXNode* dep0;
+    const SXNode* dep1;
+    bool operator==(const SXOpKey& k) const {
+      return op==k.op && dep0==k.dep0 && dep1==k.dep1;
+    }
+  };
+
+  struct SXOpKeyHash {
+    size_t operator()(const SXOpKey& k) const {
+      size_t seed = 0;
+      hash_combine(seed, k.op);
+      hash_combine(seed, reinterpret_cast<size_t>(k.dep0));
+      hash_combine(seed, reinterpret_cast<size_t>(k.dep1));
+      return seed;
+    }
+  };
+
+  template<>
+  vector<SX> CASADI_EXPORT SX::cse(const vector<SX>& e) {
+    // Sort the expression
+    Function f("tmp", vector<SX>(), e);
+    SXFunction *ff = f.get<SXFunction>();
+
+    // Iterators to the operations, constants and free variables
+    vector<SXElem>::const_iterator b_it=ff->operations_.begin();
+    vector<SXElem>::const_iterator c_it = ff->constants_.begin();
+    vector<SXElem>::const_iterator p_it = ff->free_vars_.begin();
+
+    // Canonical expression for each operation and constant encountered
+    unordered_map<SXOpKey, SXElem, SXOpKeyHash> ops;
+    unordered_map<uint64_t, SXElem> consts;
+
+    // Return value with the same sparsity patterns
+    vector<SX> ret(e.size());
+    for (casadi_int i=0; i<e.size(); ++i) ret[i] = SX::zeros(e[i].sparsity());
+
+    // Evaluate the algorithm, replacing every node with its canonical counterpart
+    vector<SXElem> w(f.sz_w());
+    for (auto&& a : ff->algorithm_) {
+      switch (a.op) {
+      case OP_OUTPUT:
+        ret.at(a.i0)->at(a.i2) = w[a.i1];
+        break;
+      case OP_CONST:
+        {
+          // Same value, bitwise (distinguishes -0 and NaN payloads)
+          uint64_t bits;
+          std::memcpy(&bits, &a.d, sizeof(bits));
+          auto ins = consts.insert(make_pair(bits, *c_it++));
+          w[a.i0] = ins.first->second;
+        }
+        break;
+      case OP_PARAMETER:
+        w[a.i0] = *p_it++;
+        break;
+      default:
+        {
+          const SXElem& orig = *b_it++;
+          casadi_int ndeps = casadi_math<double>::ndeps(a.op);
+          SXOpKey key;
+          key.op = a.op;
+          key.dep0 = w[a.i1].get();
+          key.dep1 = ndeps==2 ? w[a.i2].get() : nullptr;
+          // Commutative operations do not depend on the order of the arguments
+          if (ndeps==2 && operation_checker<CommChecker>(a.op) && key.dep1<key.dep0) {
+            swap(key.dep0, key.dep1);
+          }
+          auto it = ops.find(key);
+          if (it!=ops.end()) {
+            w[a.i0] = it->second;
+            break;
+          }
+          // Reuse the original node if the dependencies are unchanged
+          SXElem r;
+          if (orig.dep(0).get()==w[a.i1].get()
+              && (ndeps==1 || orig.dep(1).get()==w[a.i2].get())) {
+            r = orig;
+          } else {
+            switch (a.op) {
+              CASADI_MATH_FUN_BUILTIN(w[a.i1], w[a.i2], r)
+            }
+          }
+          ops.insert(make_pair(key, r));
+          w[a.i0] = r;
+        }
+      }
+    }
+    return ret;
+  }
+
   template<>
   SX CASADI_EXPORT SX::poly_coeff(const SX& ex, const SX& x) {
     casadi_assert_dev(ex.is_scalar());
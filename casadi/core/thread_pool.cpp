@@ -0,0 +1,194 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#include "thread_pool.hpp"
+#include "global_options.hpp"
+#include <algorithm>
+#include <chrono>
+
+using namespace std;
+
+namespace casadi {
+
+  ThreadPool& ThreadPool::instance() {
+    static ThreadPool pool;
+    return pool;
+  }
+
+#ifndef CASADI_WITH_THREAD
+
+  ThreadPool::~ThreadPool() {
+  }
+
+  void ThreadPool::parallel_for(casadi_int n, const std::function<void(casadi_int)>& fcn) {
+    for (casadi_int i=0; i<n; ++i) fcn(i);
+  }
+
+  casadi_int ThreadPool::n_workers() const {
+    return 0;
+  }
+
+#else // CASADI_WITH_THREAD
+
+  ThreadPool::ThreadPool() : pending_(0), stop_(false), rr_(0) {
+    // Number of workers, the calling thread is also working
+    casadi_int n = GlobalOptions::max_num_threads;
+    if (n<=0) n = thread::hardware_concurrency();
+    start(std::max(n-1, casadi_int(1)));
+  }
+
+  ThreadPool::~ThreadPool() {
+    stop();
+  }
+
+  casadi_int ThreadPool::n_workers() const {
+    return workers_.size();
+  }
+
+  void ThreadPool::start(casadi_int n) {
+    for (casadi_int w=0; w<n; ++w) workers_.emplace_back(new Worker());
+    for (casadi_int w=0; w<n; ++w) workers_[w]->th = thread(&ThreadPool::run, this, w);
+  }
+
+  void ThreadPool::stop() {
+    {
+      lock_guard<mutex> lock(mtx_);
+      stop_ = true;
+    }
+    cv_.notify_all();
+    for (auto&& w : workers_) {
+      if (w->th.joinable()) w->th.join();
+    }
+    workers_.clear();
+  }
+
+  void ThreadPool::help(Job& job) {
+    // Aim for chunks that take about this long [ns]
+    const double target_ns = 20000;
+    // Upper bound on the chunk size, leaving work for other threads to steal
+    casadi_int max_chunk = std::max(job.n/16, casadi_int(1));
+    for (;;) {
+      casadi_int chunk = job.chunk.load();
+      casadi_int i0 = job.next.fetch_add(chunk);
+      if (i0>=job.n) return;
+      casadi_int i1 = std::min(i0+chunk, job.n);
+
+      // Evaluate chunk
+      auto t0 = chrono::steady_clock::now();
+      for (casadi_int i=i0; i<i1; ++i) (*job.fcn)(i);
+      double dt = chrono::duration<double, nano>(chrono::steady_clock::now()-t0).count();
+
+      // Adapt chunk size to the measured cost per item
+      double per_item = std::max(dt/static_cast<double>(i1-i0), 1.);
+      casadi_int c = static_cast<casadi_int>(target_ns/per_item);
+      job.chunk.store(std::min(std::max(c, casadi_int(1)), max_chunk));
+
+      // Signal completion of the last item
+      if (job.done.fetch_add(i1-i0) + (i1-i0) == job.n) {
+        lock_guard<mutex> lock(job.mtx);
+        job.cv.notify_all();
+      }
+    }
+  }
+
+  shared_ptr<ThreadPool::Job> ThreadPool::find_job(casadi_int w) {
+    casadi_int nw = workers_.size();
+    shared_ptr<Job> job;
+    // Own deque first (most recently added)
+    {
+      Worker& me = *workers_[w];
+      lock_guard<mutex> lock(me.mtx);
+      if (!me.q.empty()) {
+        job = me.q.front();
+        me.q.pop_front();
+        return job;
+      }
+    }
+    // Steal from other workers (least recently added)
+    for (casadi_int k=1; k<nw; ++k) {
+      Worker& victim = *workers_[(w+k) % nw];
+      lock_guard<mutex> lock(victim.mtx);
+      if (!victim.q.empty()) {
+        job = victim.q.back();
+        victim.q.pop_back();
+        return job;
+      }
+    }
+    return job;
+  }
+
+  void ThreadPool::run(casadi_int w) {
+    for (;;) {
+      // Wait until there is a job to help with
+      {
+        unique_lock<mutex> lock(mtx_);
+        cv_.wait(lock, [this]{ return stop_ || pending_>0;});
+        if (stop_) return;
+        pending_--;
+      }
+      // A job has been reserved, but it may sit in any of the deques
+      shared_ptr<Job> job;
+      while (!(job = find_job(w))) this_thread::yield();
+      help(*job);
+    }
+  }
+
+  void ThreadPool::parallel_for(casadi_int n, const std::function<void(casadi_int)>& fcn) {
+    if (n<=0) return;
+    if (n==1) return fcn(0);
+
+    // Create job
+    auto job = make_shared<Job>();
+    job->fcn = &fcn;
+    job->n = n;
+    job->next = 0;
+    job->done = 0;
+    job->chunk = 1;
+
+    // Invite workers to help, distributed over the deques
+    casadi_int nw = workers_.size();
+    casadi_int nh = std::min(n-1, nw);
+    for (casadi_int k=0; k<nh; ++k) {
+      Worker& wk = *workers_[rr_.fetch_add(1) % nw];
+      lock_guard<mutex> lock(wk.mtx);
+      wk.q.push_front(job);
+    }
+    {
+      lock_guard<mutex> lock(mtx_);
+      pending_ += nh;
+    }
+    cv_.notify_all();
+
+    // The calling thread takes part
+    help(*job);
+
+    // Wait for items claimed by other threads
+    unique_lock<mutex> lock(job->mtx);
+    job->cv.wait(lock, [&job]{ return job->done.load()==job->n;});
+  }
+
+#endif // CASADI_WITH_THREAD
+
+} // namespace casadi
@@ -0,0 +1,137 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#ifndef CASADI_THREAD_POOL_HPP
+#define CASADI_THREAD_POOL_HPP
+
+#include "casadi_common.hpp"
+#include <functional>
+
+#ifdef CASADI_WITH_THREAD
+#include <atomic>
+#include <deque>
+#include <memory>
+#ifdef CASADI_WITH_THREAD_MINGW
+#include <mingw.thread.h>
+#include <mingw.mutex.h>
+#include <mingw.condition_variable.h>
+#else // CASADI_WITH_THREAD_MINGW
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#endif // CASADI_WITH_THREAD_MINGW
+#endif // CASADI_WITH_THREAD
+
+/// \cond INTERNAL
+
+namespace casadi {
+
+  /** \brief Process-wide pool of worker threads with work stealing
+
+      A parallel loop is split into chunks that are claimed dynamically.
+      The chunk size adapts to the measured cost per item. Each worker holds a
+      deque of jobs to help with and steals from the other workers when its
+      own deque is empty. The calling thread always takes part in its own
+      loop, so nested parallel loops (e.g. a ThreadMap inside a ThreadMap)
+      reuse the same workers instead of spawning new threads.
+
+      The number of workers is given by GlobalOptions::max_num_threads
+      (0: hardware concurrency, minus the calling thread).
+  */
+  class CASADI_EXPORT ThreadPool {
+  public:
+    /// Access the process-wide instance
+    static ThreadPool& instance();
+
+    /// Destructor, joins the workers
+    ~ThreadPool();
+
+    /// Evaluate fcn(i) for i=0..n-1, blocking until all have finished
+    void parallel_for(casadi_int n, const std::function<void(casadi_int)>& fcn);
+
+    /// Number of worker threads (not counting calling threads)
+    casadi_int n_workers() const;
+
+#ifdef CASADI_WITH_THREAD
+  private:
+    /// Constructor (use instance())
+    ThreadPool();
+
+    // A parallel loop
+    struct Job {
+      const std::function<void(casadi_int)>* fcn;
+      casadi_int n;
+      // Next item to be claimed
+      std::atomic<casadi_int> next;
+      // Number of finished items
+      std::atomic<casadi_int> done;
+      // Number of items claimed at once
+      std::atomic<casadi_int> chunk;
+      // Signal completion
+      std::mutex mtx;
+      std::condition_variable cv;
+    };
+
+    // A worker thread with its own deque of jobs
+    struct Worker {
+      std::thread th;
+      std::deque<std::shared_ptr<Job> > q;
+      std::mutex mtx;
+    };
+
+    /// Claim and evaluate chunks until the job is exhausted
+    static void help(Job& job);
+
+    /// Get a job to help with, own deque first, then steal from others
+    std::shared_ptr<Job> find_job(casadi_int w);
+
+    /// Worker main loop
+    void run(casadi_int w);
+
+    /// Start workers
+    void start(casadi_int n);
+
+    /// Stop and join workers
+    void stop();
+
+    // Workers
+    std::vector<std::unique_ptr<Worker> > workers_;
+
+    // Sleep/wake-up of idle workers
+    std::mutex mtx_;
+    std::condition_variable cv_;
+    casadi_int pending_;
+    bool stop_;
+
+    // Round-robin start index for distributing jobs
+    std::atomic<casadi_int> rr_;
+#endif // CASADI_WITH_THREAD
+  };
+
+} // namespace casadi
+
+/// \endcond
+
+#endif // CASADI_THREAD_POOL_HPP
@@ -61,7 +61,19 @@ namespace casadi {
         "Minimum R entry before singularity is declared [1e-12]"}},
       {"cache",
        {OT_DOUBLE,
-        "Amount of factorisations to remember (thread-local) [0]"}}
+        "Amount of factorisations to remember (thread-local) [0]"}},
+      {"precision",
+       {OT_STRING,
+        "Precision of the factorization and solves: 'double' or 'single'. "
+        "Combine 'single' with 'max_refine' for double precision accuracy [double]"}},
+      {"max_refine",
+       {OT_INT,
+        "Maximum number of iterative refinement steps, "
+        "with residuals computed in double precision [0]"}},
+      {"refine_tol",
+       {OT_DOUBLE,
+        "Stop the refinement when the residual infinity norm, relative "
+        "to the right-hand side, is below this value [1e-14]"}}
      }
   };
 
@@ -72,13 +84,30 @@ namespace casadi {
     // Read options
     eps_ = 1e-12;
     n_cache_ = 0;
+    single_ = false;
+    max_refine_ = 0;
+    refine_tol_ = 1e-14;
     for (auto&& op : opts) {
       if (op.first=="eps") {
         eps_ = op.second;
       } else if (op.first=="cache") {
         n_cache_ = op.second;
+      } else if (op.first=="precision") {
+        std::string precision = op.second;
+        if (precision=="single") {
+          single_ = true;
+        } else if (precision!="double") {
+          casadi_error("Unknown 'precision': " + precision
+                       + ". Allowed values: 'double', 'single'");
+        }
+      } else if (op.first=="max_refine") {
+        max_refine_ = op.second;
+      } else if (op.first=="refine_tol") {
+        refine_tol_ = op.second;
       }
     }
+    casadi_assert(!single_ || n_cache_==0,
+      "Options 'cache' and 'precision' 'single' cannot be combined");
 
     // Symbolic factorization
     sp_.qr_sparse(sp_v_, sp_r_, prinv_, pc_);
@@ -102,6 +131,22 @@ namespace casadi {
     m->cache.resize(cache_stride_*n_cache_);
     m->cache_loc.resize(n_cache_, -1);
 
+    // Memory for single precision
+    if (single_) {
+      m->v_s.resize(sp_v_.nnz());
+      m->r_s.resize(sp_r_.nnz());
+      m->beta_s.resize(ncol());
+      m->w_s.resize(nrow() + ncol());
+      m->a_s.resize(sp_.nnz());
+      m->x_s.resize(nrow());
+    }
+
+    // Memory for iterative refinement
+    if (max_refine_>0) {
+      m->b.resize(nrow());
+      m->res.resize(nrow());
+    }
+
     return 0;
   }
 
@@ -112,6 +157,27 @@ namespace casadi {
   int LinsolQr::nfact(void* mem, const double* A) const {
     auto m = static_cast<LinsolQrMemory*>(mem);
 
+    // Factorize in single precision
+    if (single_) {
+      std::copy(A, A+sp_.nnz(), m->a_s.begin());
+      casadi_qr(sp_, get_ptr(m->a_s), get_ptr(m->w_s),
+                sp_v_, get_ptr(m->v_s), sp_r_, get_ptr(m->r_s),
+                get_ptr(m->beta_s), get_ptr(prinv_), get_ptr(pc_));
+      float rmin;
+      casadi_int irmin, nullity;
+      nullity = casadi_qr_singular(&rmin, &irmin, get_ptr(m->r_s), sp_r_, get_ptr(pc_),
+                                   static_cast<float>(eps_));
+      if (nullity) {
+        if (verbose_) {
+          print("Singularity detected: Rank %lld<%lld\n", ncol()-nullity, ncol());
+          print("First singular R entry: %g<%g, corresponding to row %lld\n",
+                static_cast<double>(rmin), eps_, irmin);
+        }
+        return 1;
+      }
+      return 0;
+    }
+
     // Check for a cache hit
     double* cache = nullptr;
     bool cache_hit = cache_check(A, get_ptr(m->cache), get_ptr(m->cache_loc),
@@ -155,11 +221,45 @@ namespace casadi {
     return 0;
   }
 
+  void LinsolQr::solve1(LinsolQrMemory* m, double* x, bool tr) const {
+    if (single_) {
+      std::copy(x, x+nrow(), m->x_s.begin());
+      casadi_qr_solve(get_ptr(m->x_s), 1, tr,
+                      sp_v_, get_ptr(m->v_s), sp_r_, get_ptr(m->r_s),
+                      get_ptr(m->beta_s), get_ptr(prinv_), get_ptr(pc_), get_ptr(m->w_s));
+      std::copy(m->x_s.begin(), m->x_s.end(), x);
+    } else {
+      casadi_qr_solve(x, 1, tr,
+                      sp_v_, get_ptr(m->v), sp_r_, get_ptr(m->r),
+                      get_ptr(m->beta), get_ptr(prinv_), get_ptr(pc_), get_ptr(m->w));
+    }
+  }
+
   int LinsolQr::solve(void* mem, const double* A, double* x, casadi_int nrhs, bool tr) const {
     auto m = static_cast<LinsolQrMemory*>(mem);
-    casadi_qr_solve(x, nrhs, tr,
-                    sp_v_, get_ptr(m->v), sp_r_, get_ptr(m->r),
-                    get_ptr(m->beta), get_ptr(prinv_), get_ptr(pc_), get_ptr(m->w));
+    if (!single_ && max_refine_==0) {
+      casadi_qr_solve(x, nrhs, tr,
+                      sp_v_, get_ptr(m->v), sp_r_, get_ptr(m->r),
+                      get_ptr(m->beta), get_ptr(prinv_), get_ptr(pc_), get_ptr(m->w));
+      return 0;
+    }
+    casadi_int n = nrow();
+    for (casadi_int k=0; k<nrhs; ++k, x+=n) {
+      if (max_refine_>0) casadi_copy(x, n, get_ptr(m->b));
+      solve1(m, x, tr);
+      if (max_refine_==0) continue;
+      double b_norm = casadi_norm_inf(n, get_ptr(m->b));
+      for (casadi_int it=0; it<max_refine_; ++it) {
+        // Residual in double precision: res = b - A*x (or A'*x)
+        casadi_fill(get_ptr(m->res), n, 0.);
+        casadi_mv(A, sp_, x, get_ptr(m->res), tr);
+        for (casadi_int i=0; i<n; ++i) m->res[i] = m->b[i] - m->res[i];
+        if (casadi_norm_inf(n, get_ptr(m->res)) <= refine_tol_*b_norm) break;
+        // Correction
+        solve1(m, get_ptr(m->res), tr);
+        casadi_axpy(n, 1., get_ptr(m->res), x);
+      }
+    }
     return 0;
   }
 
@@ -219,7 +319,7 @@ namespace casadi {
   }
 
   LinsolQr::LinsolQr(DeserializingStream& s) : LinsolInternal(s) {
-    int version = s.version("LinsolQr", 1, 2);
+    int version = s.version("LinsolQr", 1, 3);
     s.unpack("LinsolQr::prinv", prinv_);
     s.unpack("LinsolQr::pc", pc_);
     s.unpack("LinsolQr::sp_v", sp_v_);
@@ -230,17 +330,29 @@ namespace casadi {
     } else {
       n_cache_ = 1;
     }
+    if (version>2) {
+      s.unpack("LinsolQr::single", single_);
+      s.unpack("LinsolQr::max_refine", max_refine_);
+      s.unpack("LinsolQr::refine_tol", refine_tol_);
+    } else {
+      single_ = false;
+      max_refine_ = 0;
+      refine_tol_ = 1e-14;
+    }
   }
 
   void LinsolQr::serialize_body(SerializingStream &s) const {
     LinsolInternal::serialize_body(s);
-    s.version("LinsolQr", 2);
+    s.version("LinsolQr", 3);
     s.pack("LinsolQr::prinv", prinv_);
     s.pack("LinsolQr::pc", pc_);
     s.pack("LinsolQr::sp_v", sp_v_);
     s.pack("LinsolQr::sp_r", sp_r_);
     s.pack("LinsolQr::eps", eps_);
     s.pack("LinsolQr::n_cache", n_cache_);
+    s.pack("LinsolQr::single", single_);
+    s.pack("LinsolQr::max_refine", max_refine_);
+    s.pack("LinsolQr::refine_tol", refine_tol_);
   }
 
 } // namespace casadi
@@ -41,6 +41,12 @@ namespace casadi {
     std::vector<double> v, r, beta, w;
     std::vector<double> cache;
 
+    // Single precision factorization and work vectors
+    std::vector<float> v_s, r_s, beta_s, w_s, a_s, x_s;
+
+    // Right-hand side and residual for iterative refinement
+    std::vector<double> b, res;
+
     // Cache locations sorted by access time
     std::vector<int> cache_loc;
   };
@@ -115,6 +121,16 @@ namespace casadi {
     casadi_int n_cache_;
     casadi_int cache_stride_;
 
+    /// Factorize and solve in single precision
+    bool single_;
+
+    /// Iterative refinement in double precision
+    casadi_int max_refine_;
+    double refine_tol_;
+
+    /// Solve for one right-hand side, in place, with the factorization
+    void solve1(LinsolQrMemory* m, double* x, bool tr) const;
+
     /** \brief Serialize an object without type information */
     void serialize_body(SerializingStream &s) const override;
 
@@ -0,0 +1,399 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#include "ocpqp.hpp"
+#include <numeric>
+
+using namespace std;
+namespace casadi {
+
+  extern "C"
+  int CASADI_CONIC_OCPQP_EXPORT
+  casadi_register_conic_ocpqp(Conic::Plugin* plugin) {
+    plugin->creator = Ocpqp::creator;
+    plugin->name = "ocpqp";
+    plugin->doc = Ocpqp::meta_doc.c_str();
+    plugin->version = CASADI_VERSION;
+    plugin->options = &Ocpqp::options_;
+    plugin->deserialize = &Ocpqp::deserialize;
+    return 0;
+  }
+
+  extern "C"
+  void CASADI_CONIC_OCPQP_EXPORT casadi_load_conic_ocpqp() {
+    Conic::registerPlugin(casadi_register_conic_ocpqp);
+  }
+
+  Ocpqp::Ocpqp(const std::string& name, const std::map<std::string, Sparsity> &st)
+    : Conic(name, st) {
+  }
+
+  Ocpqp::~Ocpqp() {
+    clear_mem();
+  }
+
+  const Options Ocpqp::options_
+  = {{&Conic::options_},
+     {{"N",
+       {OT_INT,
+        "OCP horizon"}},
+      {"nx",
+       {OT_INTVECTOR,
+        "Number of states, length N+1"}},
+      {"nu",
+       {OT_INTVECTOR,
+        "Number of controls, length N"}},
+      {"ng",
+       {OT_INTVECTOR,
+        "Number of non-dynamic constraints, length N+1"}},
+      {"max_iter",
+       {OT_INT,
+        "Maximum number of iterations [100]."}},
+      {"tol",
+       {OT_DOUBLE,
+        "Tolerance for the primal error, dual error and complementarity [1e-8]."}},
+      {"print_header",
+       {OT_BOOL,
+        "Print header [true]."}},
+      {"print_iter",
+       {OT_BOOL,
+        "Print iterations [true]."}}
+     }
+  };
+
+  void Ocpqp::init(const Dict& opts) {
+    // Initialize the base classes
+    Conic::init(opts);
+
+    // Default options
+    print_iter_ = true;
+    print_header_ = true;
+    casadi_int max_iter = 100;
+    double tol = 1e-8;
+    casadi_int N = 0, struct_cnt = 0;
+
+    // Read user options
+    for (auto&& op : opts) {
+      if (op.first=="N") {
+        N = op.second;
+        struct_cnt++;
+      } else if (op.first=="nx") {
+        nxs_ = op.second;
+        struct_cnt++;
+      } else if (op.first=="nu") {
+        nus_ = op.second;
+        struct_cnt++;
+      } else if (op.first=="ng") {
+        ngs_ = op.second;
+        struct_cnt++;
+      } else if (op.first=="max_iter") {
+        max_iter = op.second;
+      } else if (op.first=="tol") {
+        tol = op.second;
+      } else if (op.first=="print_iter") {
+        print_iter_ = op.second;
+      } else if (op.first=="print_header") {
+        print_header_ = op.second;
+      }
+    }
+
+    casadi_assert(struct_cnt==0 || struct_cnt==4,
+      "You must either set all of N, nx, nu, ng; "
+      "or set none at all (automatic detection).");
+
+    if (struct_cnt==0) {
+      if (detect_ocp_structure(A_, nxs_, nus_, ngs_)) {
+        // No controls in the last stage
+        nus_.push_back(0);
+      }
+      if (!check_structure()) {
+        casadi_warning("No OCP structure detected in the sparsity of A, solving as a single "
+          "dense stage. Order variables as [x0 u0 x1 u1 ... xN] and constraints as "
+          "[gap0 lincon0 gap1 lincon1 ... linconN], or consider the 'ipqp' plugin.");
+        nxs_ = {nx_};
+        nus_ = {0};
+        ngs_ = {na_};
+      } else if (verbose_) {
+        casadi_message("Detected structure: N " + str(nus_.size()-1) + ", nx " + str(nxs_) + ", "
+          "nu " + str(nus_) + ", ng " + str(ngs_) + ".");
+      }
+    } else {
+      casadi_assert(N>=0, "Option 'N' must be nonnegative");
+      casadi_assert(nxs_.size()==N+1, "Option 'nx' must have length N+1");
+      casadi_assert(nus_.size()==N, "Option 'nu' must have length N");
+      casadi_assert(ngs_.size()==N+1, "Option 'ng' must have length N+1");
+      // No controls in the last stage
+      nus_.push_back(0);
+      casadi_assert(check_structure(),
+        "H and A do not have the stage-wise structure given by "
+        "N " + str(N) + ", nx " + str(nxs_) + ", nu " + str(nus_) + ", ng " + str(ngs_) + ". "
+        "Variables must be ordered as [x0 u0 x1 u1 ... xN] and constraints as "
+        "[gap0 lincon0 gap1 lincon1 ... linconN].");
+    }
+
+    // Setup memory structure
+    set_ocpqp_prob();
+    p_.max_iter = max_iter;
+    p_.tol = tol;
+
+    // Allocate memory
+    casadi_int sz_w, sz_iw;
+    casadi_ocpqp_work(&p_, &sz_iw, &sz_w);
+    alloc_iw(sz_iw, true);
+    alloc_w(sz_w, true);
+
+    if (print_header_) {
+      // Print summary
+      print("-------------------------------------------\n");
+      print("This is casadi::OCPQP\n");
+      print("Number of variables:                       %9d\n", nx_);
+      print("Number of constraints:                     %9d\n", na_);
+      print("Number of nonzeros in H:                   %9d\n", H_.nnz());
+      print("Number of nonzeros in A:                   %9d\n", A_.nnz());
+      print("Horizon length:                            %9d\n", p_.N);
+    }
+  }
+
+  void Ocpqp::set_ocpqp_prob() {
+    p_.sp_a = A_;
+    p_.sp_h = H_;
+    p_.N = nxs_.size()-1;
+    p_.nxs = get_ptr(nxs_);
+    p_.nus = get_ptr(nus_);
+    p_.ngs = get_ptr(ngs_);
+    casadi_ocpqp_setup(&p_);
+  }
+
+  bool Ocpqp::check_structure() const {
+    // Consistent dimensions
+    casadi_int N = nxs_.size()-1;
+    if (nxs_.empty() || nus_.size()!=N+1 || ngs_.size()!=N+1 || nus_[N]!=0) return false;
+    for (casadi_int k=0; k<=N; ++k) {
+      if (nxs_[k]<0 || nus_[k]<0 || ngs_[k]<0) return false;
+    }
+    casadi_int sum_nx = std::accumulate(nxs_.begin(), nxs_.end(), casadi_int(0));
+    casadi_int sum_nu = std::accumulate(nus_.begin(), nus_.end(), casadi_int(0));
+    casadi_int sum_ng = std::accumulate(ngs_.begin(), ngs_.end(), casadi_int(0));
+    if (sum_nx + sum_nu != nx_ || sum_nx - nxs_[0] + sum_ng != na_) return false;
+    // Offsets of each stage in the variables and constraints
+    std::vector<casadi_int> oz(N+2, 0), oa(N+2, 0);
+    for (casadi_int k=0; k<=N; ++k) {
+      oz[k+1] = oz[k] + nxs_[k] + nus_[k];
+      oa[k+1] = oa[k] + (k<N ? nxs_[k+1] : 0) + ngs_[k];
+    }
+    // Stage-wise sparsity pattern
+    const casadi_int *h_colind = H_.colind(), *h_row = H_.row();
+    const casadi_int *a_colind = A_.colind(), *a_row = A_.row();
+    for (casadi_int k=0; k<=N; ++k) {
+      for (casadi_int c=oz[k]; c<oz[k+1]; ++c) {
+        // Hessian is block diagonal
+        for (casadi_int el=h_colind[c]; el<h_colind[c+1]; ++el) {
+          if (h_row[el]<oz[k] || h_row[el]>=oz[k+1]) return false;
+        }
+        // Constraints of the stage, or diagonal of the previous dynamics
+        for (casadi_int el=a_colind[c]; el<a_colind[c+1]; ++el) {
+          casadi_int r = a_row[el];
+          if (r>=oa[k] && r<oa[k+1]) continue;
+          if (k>0 && c-oz[k]<nxs_[k] && r==oa[k-1]+c-oz[k]) continue;
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  int Ocpqp::init_mem(void* mem) const {
+    if (Conic::init_mem(mem)) return 1;
+    auto m = static_cast<OcpqpMemory*>(mem);
+    m->return_status = "";
+    return 0;
+  }
+
+  int Ocpqp::
+  solve(const double** arg, double** res, casadi_int* iw, double* w, void* mem) const {
+    auto m = static_cast<OcpqpMemory*>(mem);
+    // Setup data structure
+    casadi_ocpqp_data<double> d;
+    d.prob = &p_;
+    d.nz_h = arg[CONIC_H];
+    d.g = arg[CONIC_G];
+    d.nz_a = arg[CONIC_A];
+    casadi_ocpqp_init(&d, &iw, &w);
+    // Pass bounds on z
+    casadi_copy(arg[CONIC_LBX], nx_, d.lbz);
+    casadi_copy(arg[CONIC_LBA], na_, d.lbz+nx_);
+    casadi_copy(arg[CONIC_UBX], nx_, d.ubz);
+    casadi_copy(arg[CONIC_UBA], na_, d.ubz+nx_);
+    // Pass initial guess
+    casadi_copy(arg[CONIC_X0], nx_, d.z);
+    // Reset solver
+    if (casadi_ocpqp_reset(&d)) {
+      d.f = nan;
+      casadi_fill(d.lam, nx_ + na_, nan);
+    } else {
+      while (true) {
+        // Prepare iteration
+        int flag = casadi_ocpqp_prepare(&d);
+        // Print iteration progress
+        if (print_iter_) {
+          if (d.iter % 10 == 0) {
+            print("%4s %14s %9s %9s %9s %9s\n", "iter", "cost", "pr", "du", "mu", "alpha");
+          }
+          print("%4d %14.6e %9.2e %9.2e %9.2e %9.2e\n",
+            static_cast<int>(d.iter), d.f, d.pr, d.du, d.mu, d.alpha);
+        }
+        // Make an iteration
+        if (flag || casadi_ocpqp_iterate(&d)) break;
+
+        // User interrupt
+        InterruptHandler::check();
+      }
+    }
+    // Check return flag
+    switch (d.status) {
+      case OCPQP_SUCCESS:
+        m->return_status = "success";
+        break;
+      case OCPQP_MAX_ITER:
+        m->return_status = "Maximum number of iterations reached";
+        m->unified_return_status = SOLVER_RET_LIMITED;
+        break;
+      case OCPQP_NOT_CONVEX:
+        m->return_status = "Failed to factorize the KKT system, problem not convex";
+        break;
+      case OCPQP_BAD_DYNAMICS:
+        m->return_status = "Dynamics must be equality constraints with a nonzero diagonal";
+        break;
+    }
+    m->iter_count = d.iter;
+    // Get solution
+    casadi_copy(&d.f, 1, res[CONIC_COST]);
+    casadi_copy(d.z, nx_, res[CONIC_X]);
+    casadi_copy(d.lam, nx_, res[CONIC_LAM_X]);
+    casadi_copy(d.lam+nx_, na_, res[CONIC_LAM_A]);
+    // Return
+    if (verbose_) casadi_warning(m->return_status);
+    m->success = d.status == OCPQP_SUCCESS;
+    return 0;
+  }
+
+  void Ocpqp::codegen_body(CodeGenerator& g) const {
+    g.add_auxiliary(CodeGenerator::AUX_OCPQP);
+    if (print_iter_) g.add_auxiliary(CodeGenerator::AUX_PRINTF);
+    g.local("d", "struct casadi_ocpqp_data");
+    g.local("p", "struct casadi_ocpqp_prob");
+
+    // Setup memory structure
+    g << "p.sp_a = " << g.sparsity(A_) << ";\n";
+    g << "p.sp_h = " << g.sparsity(H_) << ";\n";
+    g << "p.N = " << p_.N << ";\n";
+    g << "p.nxs = " << g.constant(nxs_) << ";\n";
+    g << "p.nus = " << g.constant(nus_) << ";\n";
+    g << "p.ngs = " << g.constant(ngs_) << ";\n";
+    g << "casadi_ocpqp_setup(&p);\n";
+
+    // Copy options
+    g << "p.max_iter = " << p_.max_iter << ";\n";
+    g << "p.tol = " << p_.tol << ";\n";
+
+    // Setup data structure
+    g << "d.prob = &p;\n";
+    g << "d.nz_h = arg[" << CONIC_H << "];\n";
+    g << "d.g = arg[" << CONIC_G << "];\n";
+    g << "d.nz_a = arg[" << CONIC_A << "];\n";
+    g << "casadi_ocpqp_init(&d, &iw, &w);\n";
+
+    g.comment("Pass bounds on z");
+    g.copy_default(g.arg(CONIC_LBX), nx_, "d.lbz", "-casadi_inf", false);
+    g.copy_default(g.arg(CONIC_LBA), na_, "d.lbz+" + str(nx_), "-casadi_inf", false);
+    g.copy_default(g.arg(CONIC_UBX), nx_, "d.ubz", "casadi_inf", false);
+    g.copy_default(g.arg(CONIC_UBA), na_, "d.ubz+" + str(nx_), "casadi_inf", false);
+
+    g.comment("Pass initial guess");
+    g.copy_default(g.arg(CONIC_X0), nx_, "d.z", "0", false);
+
+    g.comment("Solve QP");
+    g << "if (casadi_ocpqp_reset(&d)) {\n";
+    g << "d.f = " << g.constant(nan) << ";\n";
+    g << g.fill("d.lam", nx_ + na_, g.constant(nan)) << "\n";
+    g << "} else {\n";
+    g << "while (1) {\n";
+    if (print_iter_) {
+      g << "if (casadi_ocpqp_prepare(&d)) break;\n";
+      g << "if (d.iter % 10 == 0) {\n";
+      g << g.printf("%4s %14s %9s %9s %9s %9s\\n",
+        {"\"iter\"", "\"cost\"", "\"pr\"", "\"du\"", "\"mu\"", "\"alpha\""}) << "\n";
+      g << "}\n";
+      g << g.printf("%4d %14.6e %9.2e %9.2e %9.2e %9.2e\\n",
+        {"(int) d.iter", "d.f", "d.pr", "d.du", "d.mu", "d.alpha"}) << "\n";
+      g << "if (casadi_ocpqp_iterate(&d)) break;\n";
+    } else {
+      g << "if (casadi_ocpqp_prepare(&d) || casadi_ocpqp_iterate(&d)) break;\n";
+    }
+    g << "}\n";
+    g << "}\n";
+
+    g.comment("Get solution");
+    g.copy_check("&d.f", 1, g.res(CONIC_COST), false, true);
+    g.copy_check("d.z", nx_, g.res(CONIC_X), false, true);
+    g.copy_check("d.lam", nx_, g.res(CONIC_LAM_X), false, true);
+    g.copy_check("d.lam+"+str(nx_), na_, g.res(CONIC_LAM_A), false, true);
+
+    g << "return d.status != OCPQP_SUCCESS;\n";
+  }
+
+  Dict Ocpqp::get_stats(void* mem) const {
+    Dict stats = Conic::get_stats(mem);
+    auto m = static_cast<OcpqpMemory*>(mem);
+    stats["return_status"] = m->return_status;
+    return stats;
+  }
+
+  Ocpqp::Ocpqp(DeserializingStream& s) : Conic(s) {
+    s.version("Ocpqp", 1);
+    s.unpack("Ocpqp::nxs", nxs_);
+    s.unpack("Ocpqp::nus", nus_);
+    s.unpack("Ocpqp::ngs", ngs_);
+    s.unpack("Ocpqp::print_iter", print_iter_);
+    s.unpack("Ocpqp::print_header", print_header_);
+    set_ocpqp_prob();
+    s.unpack("Ocpqp::max_iter", p_.max_iter);
+    s.unpack("Ocpqp::tol", p_.tol);
+  }
+
+  void Ocpqp::serialize_body(SerializingStream &s) const {
+    Conic::serialize_body(s);
+
+    s.version("Ocpqp", 1);
+    s.pack("Ocpqp::nxs", nxs_);
+    s.pack("Ocpqp::nus", nus_);
+    s.pack("Ocpqp::ngs", ngs_);
+    s.pack("Ocpqp::print_iter", print_iter_);
+    s.pack("Ocpqp::print_header", print_header_);
+    s.pack("Ocpqp::max_iter", p_.max_iter);
+    s.pack("Ocpqp::tol", p_.tol);
+  }
+
+} // namespace casadi
@@ -0,0 +1,139 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#ifndef CASADI_OCPQP_HPP
+#define CASADI_OCPQP_HPP
+
+#include "casadi/core/conic_impl.hpp"
+#include <casadi/solvers/casadi_conic_ocpqp_export.h>
+
+/** \defgroup plugin_Conic_ocpqp
+ Solve QPs with optimal control structure using an interior-point method,
+ with Newton steps calculated by a Riccati recursion.
+
+ The variables must be ordered as [x0 u0 x1 u1 ... xN] and the constraints
+ as [gap0 lincon0 gap1 lincon1 ... linconN], where
+
+    gap: Ek xk+1 + Ak xk + Bk uk = bk,  with Ek diagonal
+    lincon: lgk <= Ck xk + Dk uk <= ugk
+
+ The stage dimensions are detected from the sparsity of A unless
+ all of N, nx, nu, ng are given. If no such structure is found, the
+ problem is solved as a single dense stage, with a warning;
+ the ipqp plugin is then usually the better choice.
+*/
+
+/** \pluginsection{Conic,ocpqp} */
+
+/// \cond INTERNAL
+namespace casadi {
+  struct CASADI_CONIC_OCPQP_EXPORT OcpqpMemory : public ConicMemory {
+    const char* return_status;
+  };
+
+  /** \brief \pluginbrief{Conic,ocpqp}
+
+      @copydoc Conic_doc
+      @copydoc plugin_Conic_ocpqp
+  */
+  class CASADI_CONIC_OCPQP_EXPORT Ocpqp : public Conic {
+  public:
+    /** \brief  Create a new Solver */
+    explicit Ocpqp(const std::string& name,
+                   const std::map<std::string, Sparsity> &st);
+
+    /** \brief  Create a new QP Solver */
+    static Conic* creator(const std::string& name,
+                          const std::map<std::string, Sparsity>& st) {
+      return new Ocpqp(name, st);
+    }
+
+    /** \brief  Destructor */
+    ~Ocpqp() override;
+
+    // Get name of the plugin
+    const char* plugin_name() const override { return "ocpqp";}
+
+    // Get name of the class
+    std::string class_name() const override { return "Ocpqp";}
+
+    /** \brief Create memory block */
+    void* alloc_mem() const override { return new OcpqpMemory();}
+
+    /** \brief Initalize memory block */
+    int init_mem(void* mem) const override;
+
+    /** \brief Free memory block */
+    void free_mem(void *mem) const override { delete static_cast<OcpqpMemory*>(mem);}
+
+    ///@{
+    /** \brief Options */
+    static const Options options_;
+    const Options& get_options() const override { return options_;}
+    ///@}
+
+    /** \brief Initialize */
+    void init(const Dict& opts) override;
+
+    /** \brief Solve the QP */
+    int solve(const double** arg, double** res,
+             casadi_int* iw, double* w, void* mem) const override;
+
+    /// Get all statistics
+    Dict get_stats(void* mem) const override;
+
+    /** \brief Generate code for the function body */
+    void codegen_body(CodeGenerator& g) const override;
+
+    /// A documentation string
+    static const std::string meta_doc;
+    // Memory structure
+    casadi_ocpqp_prob<double> p_;
+    // Stage dimensions, length N+1
+    std::vector<casadi_int> nxs_, nus_, ngs_;
+    ///@{
+    // Options
+    bool print_iter_, print_header_;
+    ///@}
+
+    void serialize_body(SerializingStream &s) const override;
+
+    /** \brief Deserialize with type disambiguation */
+    static ProtoFunction* deserialize(DeserializingStream& s) { return new Ocpqp(s); }
+
+  protected:
+     /** \brief Deserializing constructor */
+    explicit Ocpqp(DeserializingStream& s);
+
+  private:
+    void set_ocpqp_prob();
+
+    // Check that H and A have the stage-wise structure
+    bool check_structure() const;
+  };
+
+} // namespace casadi
+/// \endcond
+#endif // CASADI_OCPQP_HPP
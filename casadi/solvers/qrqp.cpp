@@ -80,7 +80,17 @@ namespace casadi {
         "Printed numbers are 0-based indices into the vector of [simple bounds;linear bounds]"}},
       {"min_lam",
        {OT_DOUBLE,
-        "Smallest multiplier treated as inactive for the initial active set [0]."}}
+        "Smallest multiplier treated as inactive for the initial active set [0]."}},
+      {"warm_start",
+       {OT_BOOL,
+        "Start from the solution and active set of the previous call, ignoring "
+        "x0, lam_x0 and lam_a0, and keep the QR factorization of the KKT system "
+        "for as long as H, A and the active set are unchanged [false]. "
+        "Not supported in generated code."}},
+      {"max_update",
+       {OT_INT,
+        "Maximum number of active-set changes handled by low-rank updates "
+        "of the QR factorization of the KKT system before refactorizing [0]."}}
      }
   };
 
@@ -105,6 +115,7 @@ namespace casadi {
     print_header_ = true;
     print_info_ = true;
     print_lincomb_ = false;
+    warm_start_ = false;
 
     // Read user options
     for (auto&& op : opts) {
@@ -116,6 +127,9 @@ namespace casadi {
         p_.dual_inf_tol = op.second;
       } else if (op.first=="min_lam") {
         p_.min_lam = op.second;
+      } else if (op.first=="max_update") {
+        p_.max_update = op.second;
+        casadi_assert(p_.max_update>=0, "Option 'max_update' must be nonnegative");
       } else if (op.first=="print_iter") {
         print_iter_ = op.second;
       } else if (op.first=="print_header") {
@@ -124,6 +138,8 @@ namespace casadi {
         print_info_ = op.second;
       } else if (op.first=="print_lincomb") {
         print_lincomb_ = op.second;
+      } else if (op.first=="warm_start") {
+        warm_start_ = op.second;
       }
     }
 
@@ -163,9 +179,34 @@ namespace casadi {
     if (Conic::init_mem(mem)) return 1;
     auto m = static_cast<QrqpMemory*>(mem);
     m->return_status = "";
+    m->has_solution = false;
+    if (warm_start_) {
+      m->z.resize(nx_);
+      m->lam.resize(nx_ + na_);
+      m->nz_h.assign(H_.nnz(), 0);
+      m->nz_a.assign(A_.nnz(), 0);
+      m->nz_kkt.resize(kkt_.nnz());
+      m->nz_v.resize(max(sp_v_.nnz() + sp_r_.nnz(), kkt_.nnz()));
+      m->beta.resize(nx_ + na_);
+      // No factorization yet
+      m->qr_as.assign(nx_ + na_, -1);
+    }
     return 0;
   }
 
+  // Update a copy of the data, return whether it changed
+  static bool update_copy(const double* x, std::vector<double>& c) {
+    bool changed = false;
+    for (casadi_int k=0; k<c.size(); ++k) {
+      double v = x ? x[k] : 0;
+      if (v!=c[k]) {
+        c[k] = v;
+        changed = true;
+      }
+    }
+    return changed;
+  }
+
   int Qrqp::
   solve(const double** arg, double** res, casadi_int* iw, double* w, void* mem) const {
     auto m = static_cast<QrqpMemory*>(mem);
@@ -178,16 +219,33 @@ namespace casadi {
     d.g = arg[CONIC_G];
     d.nz_a = arg[CONIC_A];
     casadi_qp_init(&d, &iw, &w);
+    if (warm_start_) {
+      // Keep the KKT system and its factorization in the memory object
+      d.nz_kkt = get_ptr(m->nz_kkt);
+      d.nz_v = get_ptr(m->nz_v);
+      d.nz_r = d.nz_v + sp_v_.nnz();
+      d.beta = get_ptr(m->beta);
+      d.qr_as = get_ptr(m->qr_as);
+      // Factorization is only valid for the same H and A
+      bool changed = update_copy(d.nz_h, m->nz_h);
+      changed = update_copy(d.nz_a, m->nz_a) || changed;
+      if (changed) casadi_fill(get_ptr(m->qr_as), m->qr_as.size(), casadi_int(-1));
+    }
     // Pass bounds on z
     casadi_copy(arg[CONIC_LBX], nx_, d.lbz);
     casadi_copy(arg[CONIC_LBA], na_, d.lbz+nx_);
     casadi_copy(arg[CONIC_UBX], nx_, d.ubz);
     casadi_copy(arg[CONIC_UBA], na_, d.ubz+nx_);
     // Pass initial guess
-    casadi_copy(arg[CONIC_X0], nx_, d.z);
+    if (warm_start_ && m->has_solution) {
+      casadi_copy(get_ptr(m->z), nx_, d.z);
+      casadi_copy(get_ptr(m->lam), nx_ + na_, d.lam);
+    } else {
+      casadi_copy(arg[CONIC_X0], nx_, d.z);
+      casadi_copy(arg[CONIC_LAM_X0], nx_, d.lam);
+      casadi_copy(arg[CONIC_LAM_A0], na_, d.lam+nx_);
+    }
     casadi_fill(d.z+nx_, na_, nan);
-    casadi_copy(arg[CONIC_LAM_X0], nx_, d.lam);
-    casadi_copy(arg[CONIC_LAM_A0], na_, d.lam+nx_);
     // Reset solver
     if (casadi_qp_reset(&d)) return 1;
     while (true) {
@@ -235,6 +293,13 @@ namespace casadi {
         m->return_status = "Printing error";
         break;
     }
+    m->iter_count = d.iter;
+    // Keep solution for the next call
+    if (warm_start_) {
+      m->has_solution = d.status == QP_SUCCESS;
+      casadi_copy(d.z, nx_, get_ptr(m->z));
+      casadi_copy(d.lam, nx_ + na_, get_ptr(m->lam));
+    }
     // Get solution
     casadi_copy(&d.f, 1, res[CONIC_COST]);
     casadi_copy(d.z, nx_, res[CONIC_X]);
@@ -271,6 +336,7 @@ namespace casadi {
     g << "p.min_lam = " << p_.min_lam << ";\n";
     g << "p.constr_viol_tol = " << p_.constr_viol_tol << ";\n";
     g << "p.dual_inf_tol = " << p_.dual_inf_tol << ";\n";
+    g << "p.max_update = " << p_.max_update << ";\n";
 
     // Setup data structure
     g << "d.prob = &p;\n";
@@ -331,7 +397,7 @@ namespace casadi {
   }
 
   Qrqp::Qrqp(DeserializingStream& s) : Conic(s) {
-    s.version("Qrqp", 1);
+    int version = s.version("Qrqp", 1, 3);
     s.unpack("Qrqp::AT", AT_);
     s.unpack("Qrqp::kkt", kkt_);
     s.unpack("Qrqp::sp_v", sp_v_);
@@ -347,12 +413,18 @@ namespace casadi {
     s.unpack("Qrqp::min_lam", p_.min_lam);
     s.unpack("Qrqp::constr_viol_tol", p_.constr_viol_tol);
     s.unpack("Qrqp::dual_inf_tol", p_.dual_inf_tol);
+    if (version>=2) {
+      s.unpack("Qrqp::warm_start", warm_start_);
+    } else {
+      warm_start_ = false;
+    }
+    if (version>=3) s.unpack("Qrqp::max_update", p_.max_update);
   }
 
   void Qrqp::serialize_body(SerializingStream &s) const {
     Conic::serialize_body(s);
 
-    s.version("Qrqp", 1);
+    s.version("Qrqp", 3);
     s.pack("Qrqp::AT", AT_);
     s.pack("Qrqp::kkt", kkt_);
     s.pack("Qrqp::sp_v", sp_v_);
@@ -367,6 +439,8 @@ namespace casadi {
     s.pack("Qrqp::min_lam", p_.min_lam);
     s.pack("Qrqp::constr_viol_tol", p_.constr_viol_tol);
     s.pack("Qrqp::dual_inf_tol", p_.dual_inf_tol);
+    s.pack("Qrqp::warm_start", warm_start_);
+    s.pack("Qrqp::max_update", p_.max_update);
   }
 
 } // namespace casadi
@@ -39,6 +39,14 @@
 namespace casadi {
   struct CASADI_CONIC_QRQP_EXPORT QrqpMemory : public ConicMemory {
     const char* return_status;
+    // Warm start: solution of the previous call
+    bool has_solution;
+    std::vector<double> z, lam;
+    // Warm start: H and A of the kept factorization
+    std::vector<double> nz_h, nz_a;
+    // Warm start: KKT, its QR factorization and the corresponding active set
+    std::vector<double> nz_kkt, nz_v, beta;
+    std::vector<casadi_int> qr_as;
   };
 
   /** \brief \pluginbrief{Conic,qrqp}
@@ -109,6 +117,7 @@ namespace casadi {
     ///@{
     // Options
     bool print_iter_, print_header_, print_info_, print_lincomb_;
+    bool warm_start_;
     ///@}
 
     void serialize_body(SerializingStream &s) const override;
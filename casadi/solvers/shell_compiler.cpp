@@ -27,7 +27,19 @@
 #include "casadi/core/casadi_misc.hpp"
 #include "casadi/core/casadi_meta.hpp"
 #include "casadi/core/casadi_logger.hpp"
+#include "casadi/core/thread_pool.hpp"
 #include <fstream>
+#include <algorithm>
+#include <map>
+#include <cstdint>
+#include <tuple>
+#include <cerrno>
+
+#ifndef _WIN32
+#include <sys/stat.h>
+#include <dirent.h>
+#include <utime.h>
+#endif // _WIN32
 
 // Set default object file suffix
 #ifndef OBJECT_FILE_SUFFIX
@@ -55,9 +67,18 @@ namespace casadi {
     ImporterInternal::registerPlugin(casadi_register_importer_shell);
   }
 
+  // Compilation cache statistics of the process, per cache directory
+  struct CacheStats {
+    casadi_int hits = 0;
+    casadi_int misses = 0;
+  };
+  static std::mutex cache_stats_mtx;
+  static std::map<std::string, CacheStats> cache_stats;
+
   ShellCompiler::ShellCompiler(const std::string& name) :
     ImporterInternal(name) {
       handle_ = nullptr;
+      cache_hit_ = false;
   }
 
   ShellCompiler::~ShellCompiler() {
@@ -68,9 +89,13 @@ namespace casadi {
     if (handle_) dlclose(handle_);
 #endif // _WIN32
 
-    if (cleanup_) {
+    // Libraries loaded from the cache are shared with other processes
+    if (cleanup_ && !cache_hit_) {
       if (remove(bin_name_.c_str())) casadi_warning("Failed to remove " + bin_name_);
       if (remove(obj_name_.c_str())) casadi_warning("Failed to remove " + obj_name_);
+      for (const std::string& s : extra_obj_names_) {
+        if (remove(s.c_str())) casadi_warning("Failed to remove " + s);
+      }
       for (const std::string& s : extra_suffixes_) {
         std::string name = base_name_+s;
         remove(name.c_str());
@@ -131,6 +156,21 @@ namespace casadi {
         "This is desired for thread-safety. "
         "This behaviour may defeat caching compiler wrappers. "
         "Default: true"}},
+      {"sources",
+       {OT_STRINGVECTOR,
+        "Additional source files, e.g. chunks written by the code generator. "
+        "All sources are compiled in parallel and linked into the same library. "
+        "Default: None"}},
+      {"cache_dir",
+       {OT_STRING,
+        "Directory of a persistent compilation cache, shared between processes. "
+        "Libraries are keyed on a hash of the sources and the compiler commands "
+        "and reused instead of compiling. The directory is created if missing. "
+        "Default: '' (no caching)"}},
+      {"cache_size",
+       {OT_INT,
+        "Maximum size of the compilation cache in bytes. Least recently used "
+        "libraries are removed when exceeded. Default: 0 (unbounded)"}},
      }
   };
 
@@ -146,7 +186,10 @@ namespace casadi {
 
     vector<string> compiler_flags;
     vector<string> linker_flags;
+    vector<string> sources;
     string suffix = OBJECT_FILE_SUFFIX;
+    cache_dir_ = "";
+    cache_size_ = 0;
 
 #ifdef _WIN32
     string compiler = "cl.exe";
@@ -191,8 +234,21 @@ namespace casadi {
         bare_name = op.second.to_string();
       } else if (op.first=="temp_suffix") {
         temp_suffix = op.second;
+      } else if (op.first=="sources") {
+        sources = op.second;
+      } else if (op.first=="cache_dir") {
+        cache_dir_ = op.second.to_string();
+      } else if (op.first=="cache_size") {
+        cache_size_ = op.second;
       }
     }
+    casadi_assert(cache_size_>=0, "Option 'cache_size' must be nonnegative");
+#ifdef _WIN32
+    if (!cache_dir_.empty()) {
+      casadi_warning("Option 'cache_dir' is not supported on Windows, ignored");
+      cache_dir_.clear();
+    }
+#endif // _WIN32
 
     // Name of temporary file
     if (temp_suffix) {
@@ -214,32 +270,96 @@ namespace casadi {
     }
 #endif // _WIN32
 
-    // Construct the compiler command
-    stringstream cccmd;
-    cccmd << compiler;
-    for (vector<string>::const_iterator i=compiler_flags.begin(); i!=compiler_flags.end(); ++i) {
-      cccmd << " " << *i;
+    // Object files of the additional sources
+    extra_obj_names_.clear();
+    for (casadi_int i=0; i<sources.size(); ++i) {
+      extra_obj_names_.push_back(base_name_ + "_" + str(i) + suffix);
     }
-    cccmd << " " << compiler_setup;
 
-    // C/C++ source file
-    cccmd << " " << name_;
+    // Construct the compiler commands
+    vector<string> src = sources, obj = extra_obj_names_;
+    src.insert(src.begin(), name_);
+    obj.insert(obj.begin(), obj_name_);
+    vector<string> cccmds(src.size());
+    for (casadi_int i=0; i<src.size(); ++i) {
+      stringstream cccmd;
+      cccmd << compiler;
+      for (auto&& f : compiler_flags) cccmd << " " << f;
+      cccmd << " " << compiler_setup;
+
+      // C/C++ source file
+      cccmd << " " << src[i];
+
+      // Temporary object file
+      cccmd << " " + compiler_output_flag << obj[i];
+      cccmds[i] = cccmd.str();
+      if (verbose_) casadi_message("calling \"" + cccmds[i] + "\"");
+    }
 
-    // Temporary object file
-    cccmd << " " + compiler_output_flag << obj_name_;
+    // Look up the compiled library in the cache
+    std::string key;
+    if (!cache_dir_.empty()) {
+      // Hash (64-bit FNV-1a) of the commands, without file names, and the sources
+      uint64_t hash = 14695981039346656037ULL;
+      auto hash_str = [&hash](const std::string& s) {
+        for (unsigned char ch : s) {
+          hash ^= ch;
+          hash *= 1099511628211ULL;
+        }
+        hash ^= 0xff;
+        hash *= 1099511628211ULL;
+      };
+      hash_str(compiler);
+      for (auto&& f : compiler_flags) hash_str(f);
+      hash_str(compiler_setup);
+      hash_str(linker);
+      for (auto&& f : linker_flags) hash_str(f);
+      hash_str(linker_setup);
+      for (const std::string& s : src) {
+        std::ifstream f(s, std::ios::binary);
+        casadi_assert(f.good(), "Cannot open source file " + s);
+        std::stringstream ss;
+        ss << f.rdbuf();
+        hash_str(ss.str());
+      }
+      std::stringstream ss;
+      ss << std::hex;
+      ss.width(16);
+      ss.fill('0');
+      ss << hash;
+      key = ss.str();
+      bool hit = cache_load(key);
+      {
+        std::lock_guard<std::mutex> lock(cache_stats_mtx);
+        CacheStats& cs = cache_stats[cache_dir_];
+        if (hit) {
+          cs.hits++;
+        } else {
+          cs.misses++;
+        }
+      }
+      if (hit) {
+        if (verbose_) casadi_message("Loaded \"" + bin_name_ + "\" from the cache");
+        return;
+      }
+    }
 
-    // Compile into an object
-    if (verbose_) casadi_message("calling \"" + cccmd.str() + "\"");
-    if (system(cccmd.str().c_str())) {
-      casadi_error("Compilation failed. Tried \"" + cccmd.str() + "\"");
+    // Compile into objects, in parallel
+    vector<int> failed(src.size(), 0);
+    ThreadPool::instance().parallel_for(src.size(), [&](casadi_int i) {
+      failed[i] = system(cccmds[i].c_str());
+    });
+    for (casadi_int i=0; i<src.size(); ++i) {
+      if (failed[i]) casadi_error("Compilation failed. Tried \"" + cccmds[i] + "\"");
     }
 
     // Link step
     stringstream ldcmd;
     ldcmd << linker;
 
-    // Temporary file
-    ldcmd << " " << obj_name_ << " " + linker_output_flag + bin_name_;
+    // Temporary files
+    for (const string& o : obj) ldcmd << " " << o;
+    ldcmd << " " + linker_output_flag + bin_name_;
 
     // Add flags
     for (vector<string>::const_iterator i=linker_flags.begin(); i!=linker_flags.end(); ++i) {
@@ -253,6 +373,12 @@ namespace casadi {
       casadi_error("Linking failed. Tried \"" + ldcmd.str() + "\"");
     }
 
+    // Make the library available to later processes
+    if (!key.empty()) {
+      cache_store(key);
+      cache_evict(key);
+    }
+
 #ifdef _WIN32
     handle_ = LoadLibrary(TEXT(bin_name_.c_str()));
     SetDllDirectory(NULL);
@@ -275,6 +401,105 @@ namespace casadi {
     return bin_name_;
   }
 
+  Dict ShellCompiler::get_stats() const {
+    Dict stats;
+    if (!cache_dir_.empty()) {
+      // Hits and misses of all instances in the process using the same cache_dir
+      std::lock_guard<std::mutex> lock(cache_stats_mtx);
+      const CacheStats& cs = cache_stats[cache_dir_];
+      stats["cache_hit"] = cache_hit_;
+      stats["cache_hits"] = cs.hits;
+      stats["cache_misses"] = cs.misses;
+    }
+    return stats;
+  }
+
+  bool ShellCompiler::cache_load(const std::string& key) {
+#ifndef _WIN32
+    std::string cached = cache_dir_ + "/" + key + SHARED_LIBRARY_SUFFIX;
+    // May fail if the entry does not exist or was just evicted by another process
+    handle_ = dlopen(cached.c_str(), RTLD_LAZY);
+    if (handle_==nullptr) {
+      dlerror(); // Reset error flags
+      return false;
+    }
+    // Mark as recently used
+    utime(cached.c_str(), nullptr);
+    bin_name_ = cached;
+    cache_hit_ = true;
+    return true;
+#else // _WIN32
+    return false;
+#endif // _WIN32
+  }
+
+  void ShellCompiler::cache_store(const std::string& key) const {
+#ifndef _WIN32
+    // Create the cache directory, including missing parents
+    for (size_t i=1; i<=cache_dir_.size(); ++i) {
+      if (i<cache_dir_.size() && cache_dir_[i]!='/') continue;
+      std::string dir = cache_dir_.substr(0, i);
+      if (mkdir(dir.c_str(), 0777) && errno!=EEXIST) {
+        casadi_warning("Failed to create the compilation cache directory " + dir);
+        return;
+      }
+    }
+    std::string cached = cache_dir_ + "/" + key + SHARED_LIBRARY_SUFFIX;
+    // Copy to a unique file, then rename, which is atomic for concurrent processes
+    std::string tmp = temporary_file(cache_dir_ + "/" + key + "_", ".tmp");
+    {
+      std::ifstream in(bin_name_, std::ios::binary);
+      std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+      out << in.rdbuf();
+      if (!out.good()) {
+        casadi_warning("Failed to write to the compilation cache: " + tmp);
+        remove(tmp.c_str());
+        return;
+      }
+    }
+    if (rename(tmp.c_str(), cached.c_str())) {
+      casadi_warning("Failed to add " + cached + " to the compilation cache");
+      remove(tmp.c_str());
+    }
+#endif // _WIN32
+  }
+
+  void ShellCompiler::cache_evict(const std::string& key) const {
+#ifndef _WIN32
+    if (cache_size_==0) return;
+    DIR* dir = opendir(cache_dir_.c_str());
+    if (dir==nullptr) return;
+    // Cached libraries, with last use and size
+    std::vector<std::tuple<time_t, std::string, casadi_int> > entries;
+    casadi_int total = 0;
+    std::string lib_suffix = SHARED_LIBRARY_SUFFIX;
+    std::string current = key + lib_suffix;
+    while (struct dirent* e = readdir(dir)) {
+      std::string f = e->d_name;
+      if (f.size()<=lib_suffix.size()
+          || f.compare(f.size()-lib_suffix.size(), lib_suffix.size(), lib_suffix)) continue;
+      bool is_current = f==current;
+      f = cache_dir_ + "/" + f;
+      struct stat st;
+      if (stat(f.c_str(), &st)) continue;
+      total += st.st_size;
+      // The library just stored is kept, even if it exceeds cache_size alone
+      if (!is_current) entries.emplace_back(st.st_mtime, f, st.st_size);
+    }
+    closedir(dir);
+    // Remove the least recently used first. Processes that have loaded a removed
+    // library keep using it, since unlinking does not affect existing mappings.
+    std::sort(entries.begin(), entries.end());
+    for (auto&& e : entries) {
+      if (total<=cache_size_) break;
+      if (remove(std::get<1>(e).c_str())==0) {
+        if (verbose_) casadi_message("Evicted \"" + std::get<1>(e) + "\" from the cache");
+      }
+      total -= std::get<2>(e);
+    }
+#endif // _WIN32
+  }
+
   signal_t ShellCompiler::get_function(const std::string& symname) {
 #ifdef _WIN32
     return (signal_t)GetProcAddress(handle_, TEXT(symname.c_str()));
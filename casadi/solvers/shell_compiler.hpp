@@ -85,7 +85,19 @@ namespace casadi {
     /// Get library name
     std::string library() const override;
 
+    /// Get statistics
+    Dict get_stats() const override;
+
   protected:
+    /// Try to load a library from the cache
+    bool cache_load(const std::string& key);
+
+    /// Copy the compiled library into the cache
+    void cache_store(const std::string& key) const;
+
+    /// Remove least recently used entries, except key, until the cache fits
+    void cache_evict(const std::string& key) const;
+
     std::string base_name_;
 
     /// Temporary file
@@ -94,12 +106,24 @@ namespace casadi {
     /// Temporary file
     std::string obj_name_;
 
+    /// Temporary files for the additional sources
+    std::vector<std::string> extra_obj_names_;
+
     /// Extra files
     std::vector<std::string> extra_suffixes_;
 
     /// Cleanup temporary files when unloading
     bool cleanup_;
 
+    /// Directory of the compilation cache, empty if disabled
+    std::string cache_dir_;
+
+    /// Maximum size of the compilation cache in bytes, 0 for unbounded
+    casadi_int cache_size_;
+
+    /// Library loaded from the cache
+    bool cache_hit_;
+
     // Shared library handle
     typedef DL_HANDLE_TYPE handle_t;
     handle_t handle_;
@@ -102,7 +102,17 @@ namespace casadi {
         "Size of memory to store history of merit function values"}},
       {"lbfgs_memory",
        {OT_INT,
-        "Size of L-BFGS memory."}},
+        "Size of L-BFGS memory. Without 'lbfgs_blocks', the dense approximation "
+        "is instead reset every lbfgs_memory iterations."}},
+      {"lbfgs_blocks",
+       {OT_INTVECTOR,
+        "Sizes of the diagonal blocks of the L-BFGS Hessian approximation, "
+        "e.g. the number of variables in each shooting stage. When given, the "
+        "blocks are rebuilt each iteration from the lbfgs_memory most recent "
+        "pairs, at a cost of O(lbfgs_memory*sum(nb^2)). The compact (low-rank) "
+        "representation is not implemented, since the QP solvers take an "
+        "explicit Hessian. Default: a single dense block with the incremental "
+        "dense BFGS update, O(n^2) storage and cost per iteration."}},
       {"print_header",
        {OT_BOOL,
         "Print the header with problem statistics"}},
@@ -148,9 +158,11 @@ namespace casadi {
     beta_ = 0.8;
     merit_memsize_ = 4;
     lbfgs_memory_ = 10;
+    lbfgs_blocked_ = false;
     tol_pr_ = 1e-6;
     tol_du_ = 1e-6;
     string hessian_approximation = "exact";
+    std::vector<casadi_int> lbfgs_blocks;
     min_step_size_ = 1e-10;
     string qpsol_plugin = "qpoases";
     Dict qpsol_options;
@@ -178,6 +190,8 @@ namespace casadi {
         merit_memsize_ = op.second;
       } else if (op.first=="lbfgs_memory") {
         lbfgs_memory_ = op.second;
+      } else if (op.first=="lbfgs_blocks") {
+        lbfgs_blocks = op.second;
       } else if (op.first=="tol_pr") {
         tol_pr_ = op.second;
       } else if (op.first=="tol_du") {
@@ -247,7 +261,22 @@ namespace casadi {
         Hsp_ = Convexify::setup(convexify_data_, Hsp_, opts);
       }
     } else {
-      Hsp_ = Sparsity::dense(nx_, nx_);
+      casadi_assert(lbfgs_memory_>0, "Option 'lbfgs_memory' must be positive");
+      lbfgs_blocked_ = !lbfgs_blocks.empty();
+      if (!lbfgs_blocked_) {
+        Hsp_ = Sparsity::dense(nx_, nx_);
+      } else {
+        // Block-diagonal Hessian approximation
+        std::vector<Sparsity> blocks;
+        for (casadi_int nb : lbfgs_blocks) {
+          casadi_assert(nb>0, "Option 'lbfgs_blocks' must have positive entries");
+          blocks.push_back(Sparsity::dense(nb, nb));
+        }
+        Hsp_ = diagcat(blocks);
+        casadi_assert(Hsp_.size1()==nx_,
+          "Option 'lbfgs_blocks' must sum up to the number of variables " + str(nx_) + ", "
+          "got " + str(Hsp_.size1()) + ".");
+      }
     }
 
     // Allocate a QP solver
@@ -258,7 +287,7 @@ namespace casadi {
 
     // BFGS?
     if (!exact_hessian_) {
-      alloc_w(2*nx_); // casadi_bfgs
+      alloc_w(2*nx_); // casadi_bfgs, casadi_lbfgs
     }
 
     // Header
@@ -295,6 +324,7 @@ namespace casadi {
     p_.sp_a = Asp_;
     p_.merit_memsize = merit_memsize_;
     p_.max_iter_ls = max_iter_ls_;
+    p_.lbfgs_memory = lbfgs_blocked_ ? lbfgs_memory_ : 0;
     p_.nlp = &p_nlp_;
   }
 
@@ -438,12 +468,21 @@ int Sqpmethod::solve(void* mem) const {
         // Initialize BFGS
         casadi_fill(d->Bk, Hsp_.nnz(), 1.);
         casadi_bfgs_reset(Hsp_, d->Bk);
-      } else {
+      } else if (!lbfgs_blocked_) {
         ScopedTiming tic(m->fstats.at("BFGS"));
         // Update BFGS
         if (m->iter_count % lbfgs_memory_ == 0) casadi_bfgs_reset(Hsp_, d->Bk);
-        // Update the Hessian approximation
         casadi_bfgs(Hsp_, d->Bk, d->dx, d->gLag, d->gLag_old, m->w);
+      } else {
+        ScopedTiming tic(m->fstats.at("BFGS"));
+        // Store the last step, overwriting the oldest pair
+        casadi_int last = (m->iter_count-1) % lbfgs_memory_;
+        casadi_copy(d->dx, nx_, d->Sk + last*nx_);
+        casadi_copy(d->gLag, nx_, d->Yk + last*nx_);
+        casadi_axpy(nx_, -1., d->gLag_old, d->Yk + last*nx_);
+        // Update the Hessian approximation
+        casadi_lbfgs(Hsp_, d->Bk, d->Sk, d->Yk, lbfgs_memory_,
+                     std::min<casadi_int>(m->iter_count, lbfgs_memory_), last, m->w);
       }
 
       // Formulate the QP
@@ -648,6 +687,7 @@ void Sqpmethod::codegen_declarations(CodeGenerator& g) const {
     g << "p.sp_a = " << g.sparsity(Asp_) << ";\n";
     g << "p.merit_memsize = " << merit_memsize_ << ";\n";
     g << "p.max_iter_ls = " << max_iter_ls_ << ";\n";
+    g << "p.lbfgs_memory = 0;\n";
     g << "p.nlp = &p_nlp;\n";
     g << "casadi_sqpmethod_init(&d, &iw, &w);\n";
 
@@ -866,7 +906,7 @@ void Sqpmethod::codegen_declarations(CodeGenerator& g) const {
   }
 
   Sqpmethod::Sqpmethod(DeserializingStream& s) : Nlpsol(s) {
-    int version = s.version("Sqpmethod", 1, 2);
+    int version = s.version("Sqpmethod", 1, 3);
     s.unpack("Sqpmethod::qpsol", qpsol_);
     s.unpack("Sqpmethod::exact_hessian", exact_hessian_);
     s.unpack("Sqpmethod::max_iter", max_iter_);
@@ -915,12 +955,17 @@ void Sqpmethod::codegen_declarations(CodeGenerator& g) const {
       s.unpack("Sqpmethod::convexify", convexify_);
       if (convexify_) Convexify::deserialize(s, "Sqpmethod::", convexify_data_);
     }
+    if (version>=3) {
+      s.unpack("Sqpmethod::lbfgs_blocked", lbfgs_blocked_);
+    } else {
+      lbfgs_blocked_ = false;
+    }
     set_sqpmethod_prob();
   }
 
   void Sqpmethod::serialize_body(SerializingStream &s) const {
     Nlpsol::serialize_body(s);
-    s.version("Sqpmethod", 2);
+    s.version("Sqpmethod", 3);
     s.pack("Sqpmethod::qpsol", qpsol_);
     s.pack("Sqpmethod::exact_hessian", exact_hessian_);
     s.pack("Sqpmethod::max_iter", max_iter_);
@@ -941,5 +986,6 @@ void Sqpmethod::codegen_declarations(CodeGenerator& g) const {
     s.pack("Sqpmethod::Asp", Asp_);
     s.pack("Sqpmethod::convexify", convexify_);
     if (convexify_) Convexify::serialize(s, "Sqpmethod::", convexify_data_);
+    s.pack("Sqpmethod::lbfgs_blocked", lbfgs_blocked_);
   }
 } // namespace casadi
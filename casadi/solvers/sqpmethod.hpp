@@ -121,6 +121,9 @@ namespace casadi {
     /// Memory size of L-BFGS method
     casadi_int lbfgs_memory_;
 
+    /// Limited-memory update of a block-diagonal Hessian approximation (lbfgs_blocks given)?
+    bool lbfgs_blocked_;
+
     /// Tolerance of primal and dual infeasibility
     double tol_pr_, tol_du_;
 
@@ -0,0 +1,66 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+/** \brief Calling a shared Function from many threads
+ * NOTE: Example is mainly intended for developers of CasADi.
+ * Each call checks out and releases a memory object of the shared function.
+ * Reports the time per call for an increasing number of threads.
+ */
+
+#include "casadi/casadi.hpp"
+#include <chrono>
+#include <thread>
+
+using namespace casadi;
+using namespace std;
+
+int main(){
+  // Small function, so that the checkout/release overhead is visible
+  SX x = SX::sym("x", 2);
+  Function f("f", {x}, {x(0)*x(1) + sin(x(0))});
+
+  const casadi_int n_call = 200000;
+  for (casadi_int n_thread : {1, 2, 4, 8, 16, 32}) {
+    auto t0 = chrono::high_resolution_clock::now();
+    vector<thread> threads;
+    for (casadi_int t=0; t<n_thread; ++t) {
+      threads.emplace_back([&]() {
+        double x_val[2] = {0.3, 0.4}, r_val;
+        vector<casadi_int> iw(f.sz_iw());
+        vector<double> w(f.sz_w());
+        const double* arg[1] = {x_val};
+        double* res[1] = {&r_val};
+        for (casadi_int k=0; k<n_call; ++k) f(arg, res, get_ptr(iw), get_ptr(w));
+      });
+    }
+    for (auto&& th : threads) th.join();
+    auto t1 = chrono::high_resolution_clock::now();
+    double ns = chrono::duration<double, nano>(t1-t0).count();
+    cout << n_thread << " threads: " << ns/static_cast<double>(n_call*n_thread)
+         << " ns/call (aggregate), " << ns/static_cast<double>(n_call)
+         << " ns/call (per thread)" << endl;
+  }
+  return 0;
+}
@@ -0,0 +1,115 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+/** \brief Throughput of batched (SIMD) code generation
+ * NOTE: Example is mainly intended for developers of CasADi.
+ * Generates C code for an RK4 integrator step of a pendulum with the
+ * CodeGenerator option "simd", which adds an entry point f_simd evaluating
+ * n instances at once in a structure of arrays layout. The batched entry
+ * point is compared with looping over the scalar entry point f.
+ */
+
+#include "casadi/casadi.hpp"
+#include <chrono>
+#include <dlfcn.h>
+
+using namespace casadi;
+using namespace std;
+
+typedef int (*eval_t)(const double** arg, double** res, casadi_int* iw, double* w, int mem);
+typedef int (*eval_simd_t)(const double** arg, double** res, casadi_int n,
+                           casadi_int* iw, double* w, int mem);
+
+int main() {
+  // Pendulum dynamics
+  SX x = SX::sym("x", 2), u = SX::sym("u");
+  double dt = 0.01;
+  Function ode("ode", {x, u}, {vertcat(x(1), -9.81*sin(x(0)) - 0.1*x(1) + u)});
+
+  // RK4 steps
+  SX xk = x;
+  for (casadi_int i=0; i<10; ++i) {
+    SX k1 = ode(vector<SX>{xk, u}).at(0);
+    SX k2 = ode(vector<SX>{xk + dt/2*k1, u}).at(0);
+    SX k3 = ode(vector<SX>{xk + dt/2*k2, u}).at(0);
+    SX k4 = ode(vector<SX>{xk + dt*k3, u}).at(0);
+    xk += dt/6*(k1 + 2*k2 + 2*k3 + k4);
+  }
+  Function f("f", {x, u}, {xk});
+
+  // Generate and compile
+  f.generate("f_simd.c", {{"simd", true}, {"with_header", false}});
+  string cmd = "gcc -O3 -march=native -fopenmp-simd -ffast-math -fPIC -shared "
+               "f_simd.c -o f_simd.so -lm";
+  casadi_assert(system(cmd.c_str())==0, "Compilation failed: " + cmd);
+  void* handle = dlopen("./f_simd.so", RTLD_LAZY);
+  casadi_assert(handle!=nullptr, "Cannot open f_simd.so");
+  eval_t eval = reinterpret_cast<eval_t>(dlsym(handle, "f"));
+  eval_simd_t eval_simd = reinterpret_cast<eval_simd_t>(dlsym(handle, "f_simd"));
+  casadi_assert(eval!=nullptr && eval_simd!=nullptr, "Missing entry points");
+
+  // Instances, structure of arrays layout
+  casadi_int n = 10000, n_rep = 100;
+  vector<double> xv(2*n), uv(n), r_simd(2*n), r_loop(2*n);
+  for (casadi_int k=0; k<n; ++k) {
+    xv[k] = 0.001*k;
+    xv[n+k] = 0.;
+    uv[k] = 0.1;
+  }
+
+  // Batched evaluation
+  const double* arg[2] = {get_ptr(xv), get_ptr(uv)};
+  double* res[1] = {get_ptr(r_simd)};
+  auto t0 = chrono::high_resolution_clock::now();
+  for (casadi_int r=0; r<n_rep; ++r) eval_simd(arg, res, n, nullptr, nullptr, 0);
+  auto t1 = chrono::high_resolution_clock::now();
+
+  // Loop over the scalar entry point
+  double x1[2], x1_res[2];
+  const double* arg1[2] = {x1, nullptr};
+  double* res1[1] = {x1_res};
+  auto t2 = chrono::high_resolution_clock::now();
+  for (casadi_int r=0; r<n_rep; ++r) {
+    for (casadi_int k=0; k<n; ++k) {
+      x1[0] = xv[k];
+      x1[1] = xv[n+k];
+      arg1[1] = &uv[k];
+      eval(arg1, res1, nullptr, nullptr, 0);
+      r_loop[k] = x1_res[0];
+      r_loop[n+k] = x1_res[1];
+    }
+  }
+  auto t3 = chrono::high_resolution_clock::now();
+
+  // Compare
+  double err = 0;
+  for (casadi_int i=0; i<2*n; ++i) err = fmax(err, fabs(r_simd[i]-r_loop[i]));
+  double t_simd = chrono::duration<double>(t1-t0).count() / (n*n_rep) * 1e9;
+  double t_loop = chrono::duration<double>(t3-t2).count() / (n*n_rep) * 1e9;
+  uout() << "scalar: " << t_loop << " ns/instance, simd: " << t_simd
+         << " ns/instance, max deviation: " << err << endl;
+
+  dlclose(handle);
+  return 0;
+}
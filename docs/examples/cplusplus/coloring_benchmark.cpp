@@ -0,0 +1,112 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+/** \brief Benchmark of the graph coloring algorithms
+ * NOTE: Example is mainly intended for developers of CasADi.
+ * Compares the sequential greedy distance-2 coloring with the parallel
+ * Jones-Plassmann coloring, with and without recoloring passes, on a
+ * Matrix Market pattern (default: test/data/apoa1-2.mtx) and on the
+ * Jacobian pattern of a multiple shooting optimal control problem.
+ */
+
+#include "casadi/casadi.hpp"
+#include <chrono>
+#include <fstream>
+#include <sstream>
+
+using namespace casadi;
+using namespace std;
+
+// Read the pattern of a Matrix Market file
+Sparsity read_mtx(const string& fname) {
+  ifstream in(fname);
+  casadi_assert(in.good(), "Cannot open " + fname);
+  string line;
+  bool symmetric = false;
+  // Header and comments
+  while (getline(in, line) && !line.empty() && line[0]=='%') {
+    if (line.find("symmetric")!=string::npos) symmetric = true;
+  }
+  casadi_int nrow, ncol, nnz;
+  stringstream(line) >> nrow >> ncol >> nnz;
+  vector<casadi_int> row, col;
+  for (casadi_int k=0; k<nnz; ++k) {
+    casadi_int r, c;
+    in >> r >> c;
+    getline(in, line);
+    row.push_back(r-1);
+    col.push_back(c-1);
+    if (symmetric && r!=c) {
+      row.push_back(c-1);
+      col.push_back(r-1);
+    }
+  }
+  return Sparsity::triplet(nrow, ncol, row, col);
+}
+
+// Jacobian pattern of multiple shooting constraints x_{k+1} = F(x_k, u_k)
+Sparsity ocp_jacobian(casadi_int N, casadi_int nx, casadi_int nu) {
+  vector<casadi_int> row, col;
+  casadi_int nv = nx+nu;
+  for (casadi_int k=0; k<N; ++k) {
+    for (casadi_int i=0; i<nx; ++i) {
+      // Dense dependency on x_k, u_k
+      for (casadi_int j=0; j<nv; ++j) {
+        row.push_back(k*nx+i);
+        col.push_back(k*nv+j);
+      }
+      // Identity for x_{k+1}
+      row.push_back(k*nx+i);
+      col.push_back((k+1)*nv+i);
+    }
+  }
+  return Sparsity::triplet(N*nx, (N+1)*nv, row, col);
+}
+
+void benchmark(const string& name, const Sparsity& A) {
+  cout << name << ": " << A.size1() << "-by-" << A.size2() << ", "
+       << A.nnz() << " nonzeros" << endl;
+  Sparsity AT = A.T();
+  auto t0 = chrono::high_resolution_clock::now();
+  Sparsity D_greedy = A.uni_coloring(AT);
+  auto t1 = chrono::high_resolution_clock::now();
+  Sparsity D_jp = A.jp_coloring(AT);
+  auto t2 = chrono::high_resolution_clock::now();
+  Sparsity D_re = A.recolor(D_jp, 4, AT);
+  auto t3 = chrono::high_resolution_clock::now();
+  auto ms = [](chrono::high_resolution_clock::duration d) {
+    return chrono::duration<double, milli>(d).count();};
+  cout << "  greedy:            " << D_greedy.size2() << " colors, " << ms(t1-t0) << " ms" << endl;
+  cout << "  Jones-Plassmann:   " << D_jp.size2() << " colors, " << ms(t2-t1) << " ms" << endl;
+  cout << "  + 4 recolorings:   " << D_re.size2() << " colors, " << ms(t3-t2) << " ms" << endl;
+}
+
+int main(int argc, char* argv[]){
+  string fname = argc>1 ? argv[1] : "test/data/apoa1-2.mtx";
+  benchmark(fname, read_mtx(fname));
+  benchmark("OCP Jacobian", ocp_jacobian(10000, 20, 5));
+  return 0;
+}
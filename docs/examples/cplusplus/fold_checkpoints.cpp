@@ -0,0 +1,69 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+/** \brief Memory and runtime of reverse mode through long folds
+ * NOTE: Example is mainly intended for developers of CasADi.
+ * The gradient of a 100000 step fold is evaluated with reverse mode, for
+ * different budgets of the 'checkpoints' option of fold and without it.
+ * Runs with the smallest budget come first, since the peak resident set size
+ * of the process can only grow.
+ */
+
+#include "casadi/casadi.hpp"
+#include <chrono>
+#include <sys/resource.h>
+
+using namespace casadi;
+using namespace std;
+
+// Peak resident set size in MB
+double peak_rss() {
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss/1024.;
+}
+
+int main() {
+  // One explicit Euler step of a pendulum
+  MX x = MX::sym("x", 2), u = MX::sym("u");
+  Function f("f", {x, u}, {x + 0.001*vertcat(x(1), -sin(x(0)) + u)});
+
+  casadi_int N = 100000;
+  MX X = MX::sym("X", 2), U = MX::sym("U", 1, N);
+  vector<double> x0 = {0.3, 0.1}, u0(N, 0.1);
+
+  for (casadi_int checkpoints : {30, 100, 1000, 0}) {
+    Function F = f.fold(N, {{"checkpoints", checkpoints}});
+    Function J("J", {X, U}, {gradient(sum1(F(vector<MX>{X, U}).at(0)), vertcat(X, U.T()))});
+    auto t0 = chrono::high_resolution_clock::now();
+    DM g = J(vector<DM>{x0, DM(u0).T()}).at(0);
+    auto t1 = chrono::high_resolution_clock::now();
+    uout() << "checkpoints: " << checkpoints
+           << ", work vector: " << J.sz_w()*sizeof(double)/1e6 << " MB"
+           << ", peak RSS: " << peak_rss() << " MB"
+           << ", time: " << chrono::duration<double>(t1-t0).count() << " s"
+           << ", dx0: " << g(Slice(0, 2)) << endl;
+  }
+  return 0;
+}
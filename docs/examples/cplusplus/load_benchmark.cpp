@@ -0,0 +1,64 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+/** \brief Loading times of serialized functions
+ * NOTE: Example is mainly intended for developers of CasADi.
+ * Saves a large SX function in the text and binary formats and
+ * compares the time needed to load it back, with and without mmap.
+ */
+
+#include "casadi/casadi.hpp"
+#include <chrono>
+
+using namespace casadi;
+using namespace std;
+
+double load_ms(const string& fname, const Dict& opts) {
+  auto t0 = chrono::high_resolution_clock::now();
+  Function f = Function::load(fname, opts);
+  auto t1 = chrono::high_resolution_clock::now();
+  return chrono::duration<double, milli>(t1-t0).count();
+}
+
+int main(){
+  // Large function with a long algorithm and large constant matrices
+  casadi_int n = 1000;
+  SX x = SX::sym("x", n);
+  SX z = x;
+  for (casadi_int k=0; k<20; ++k) z = sin(z) * z(range(n-1, -1, -1)) + 0.5;
+  SX A = DM::rand(n, n/10);
+  Function f("f", {x}, {z, mtimes(A.T(), z)});
+  cout << f.n_instructions() << " instructions" << endl;
+
+  f.save("load_benchmark_text.casadi");
+  f.save("load_benchmark_binary.casadi", {{"binary", true}});
+
+  cout << "text:          " << load_ms("load_benchmark_text.casadi", Dict()) << " ms" << endl;
+  cout << "binary:        " << load_ms("load_benchmark_binary.casadi", Dict()) << " ms" << endl;
+  cout << "binary + mmap: " << load_ms("load_benchmark_binary.casadi", {{"mmap", true}})
+       << " ms" << endl;
+  return 0;
+}
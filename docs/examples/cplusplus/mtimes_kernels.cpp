@@ -0,0 +1,90 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+/** \brief Timing of the matrix multiplication kernels of MX graphs
+ * NOTE: Example is mainly intended for developers of CasADi.
+ * The kernel of a multiplication node is chosen from the sparsity patterns:
+ * dense*dense, sparse*dense (dense result) or general sparse. Typical shapes
+ * from optimal control problems are evaluated and compared with the general
+ * sparse kernel casadi_mtimes.
+ */
+
+#include "casadi/casadi.hpp"
+#include "casadi/core/runtime/casadi_runtime.hpp"
+#include <chrono>
+
+using namespace casadi;
+using namespace std;
+
+void benchmark(const string& name, const Sparsity& sp_x, const Sparsity& sp_y,
+               casadi_int n_rep) {
+  MX x = MX::sym("x", sp_x), y = MX::sym("y", sp_y);
+  Function f("f", {x, y}, {mtimes(x, y)});
+  Sparsity sp_z = f.sparsity_out(0);
+
+  // Random data
+  vector<double> xv(sp_x.nnz()), yv(sp_y.nnz()), z1(sp_z.nnz()), z2(sp_z.nnz());
+  for (casadi_int i=0; i<xv.size(); ++i) xv[i] = sin(1. + i);
+  for (casadi_int i=0; i<yv.size(); ++i) yv[i] = cos(1. + i);
+
+  // Through the MX graph, kernel chosen from the sparsity patterns
+  vector<casadi_int> iw(f.sz_iw());
+  vector<double> w(f.sz_w());
+  const double* arg[2] = {get_ptr(xv), get_ptr(yv)};
+  double* res[1] = {get_ptr(z1)};
+  auto t0 = chrono::high_resolution_clock::now();
+  for (casadi_int r=0; r<n_rep; ++r) f(arg, res, get_ptr(iw), get_ptr(w), 0);
+  auto t1 = chrono::high_resolution_clock::now();
+
+  // General sparse kernel
+  vector<double> w2(sp_z.size1());
+  auto t2 = chrono::high_resolution_clock::now();
+  for (casadi_int r=0; r<n_rep; ++r) {
+    fill(z2.begin(), z2.end(), 0);
+    casadi_mtimes(get_ptr(xv), sp_x, get_ptr(yv), sp_y, get_ptr(z2), sp_z, get_ptr(w2), 0);
+  }
+  auto t3 = chrono::high_resolution_clock::now();
+
+  double err = 0;
+  for (casadi_int i=0; i<z1.size(); ++i) err = fmax(err, fabs(z1[i]-z2[i]));
+  double t_f = chrono::duration<double>(t1-t0).count() / n_rep * 1e6;
+  double t_ref = chrono::duration<double>(t3-t2).count() / n_rep * 1e6;
+  uout() << name << ": " << t_f << " us (dispatched), " << t_ref
+         << " us (casadi_mtimes), max deviation: " << err << endl;
+}
+
+int main() {
+  // Dense products, e.g. condensing or Riccati recursions
+  benchmark("dense 50x50*50x50", Sparsity::dense(50, 50), Sparsity::dense(50, 50), 1000);
+  benchmark("dense 50x50*50x1", Sparsity::dense(50, 50), Sparsity::dense(50, 1), 100000);
+  benchmark("dense 12x12*12x4", Sparsity::dense(12, 12), Sparsity::dense(12, 4), 100000);
+
+  // Banded state transition times dense sensitivities
+  Sparsity band = Sparsity::banded(100, 1);
+  benchmark("banded 100x100*100x20", band, Sparsity::dense(100, 20), 10000);
+
+  // Sparse times sparse
+  benchmark("banded 100x100*100x100 banded", band, band, 10000);
+  return 0;
+}
@@ -0,0 +1,86 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+/** \brief Single and mixed precision evaluation
+ * NOTE: Example is mainly intended for developers of CasADi.
+ * An SX function is evaluated for many random inputs in double and single
+ * precision. A linear system is then solved with a QR factorization in
+ * single precision, refined to double precision accuracy with residuals
+ * computed in double precision.
+ */
+
+#include "casadi/casadi.hpp"
+#include <chrono>
+
+using namespace casadi;
+using namespace std;
+
+int main() {
+  // Monte Carlo evaluation of a nonlinear function
+  SX x = SX::sym("x", 4);
+  SX e = x;
+  for (casadi_int i=0; i<20; ++i) e = sin(e) * x(0) + e(casadi_int(3-i%4));
+  Function f("f", {x}, {e});
+
+  casadi_int n = 100000;
+  vector<double> xd(4), rd(4), wd(f.sz_w());
+  vector<float> xs(4), rs(4), ws(f.sz_w());
+  vector<casadi_int> iw(f.sz_iw());
+  double err = 0, sum_d = 0, sum_s = 0;
+  chrono::duration<double> t_d(0), t_s(0);
+  for (casadi_int k=0; k<n; ++k) {
+    for (casadi_int i=0; i<4; ++i) xs[i] = static_cast<float>(xd[i] = sin(k + i));
+    const double* arg_d[1] = {get_ptr(xd)};
+    double* res_d[1] = {get_ptr(rd)};
+    const float* arg_s[1] = {get_ptr(xs)};
+    float* res_s[1] = {get_ptr(rs)};
+    auto t0 = chrono::high_resolution_clock::now();
+    f(arg_d, res_d, get_ptr(iw), get_ptr(wd), 0);
+    auto t1 = chrono::high_resolution_clock::now();
+    f(arg_s, res_s, get_ptr(iw), get_ptr(ws), 0);
+    auto t2 = chrono::high_resolution_clock::now();
+    t_d += t1-t0;
+    t_s += t2-t1;
+    for (casadi_int i=0; i<4; ++i) {
+      err = fmax(err, fabs(rd[i] - rs[i]));
+      sum_d += rd[i];
+      sum_s += rs[i];
+    }
+  }
+  uout() << "double: " << t_d.count()/n*1e9 << " ns, single: " << t_s.count()/n*1e9
+         << " ns, max deviation: " << err << ", mean deviation: "
+         << fabs(sum_d-sum_s)/(4*n) << endl;
+
+  // Linear system, single precision factorization with refinement
+  casadi_int m = 50;
+  DM A = DM::rand(m, m) + m*DM::eye(m), b = DM::rand(m, 1);
+  for (casadi_int max_refine : {0, 1, 2, 5}) {
+    Linsol solver("solver", "qr", A.sparsity(),
+                  {{"precision", "single"}, {"max_refine", max_refine}});
+    DM x = solver.solve(A, b);
+    uout() << "refinement steps: " << max_refine << ", residual: "
+           << norm_inf(mtimes(A, x) - b) << endl;
+  }
+  return 0;
+}
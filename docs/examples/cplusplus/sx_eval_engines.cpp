@@ -0,0 +1,81 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+/** \brief Micro-benchmark of the SXFunction virtual machines
+ * NOTE: Example is mainly intended for developers of CasADi.
+ * Evaluates the same small SX functions with the default switch-based interpreter
+ * and with the threaded-code interpreter (option "threaded_code") and reports
+ * the evaluation time per instruction of the original algorithm.
+ */
+
+#include "casadi/casadi.hpp"
+#include <chrono>
+
+using namespace casadi;
+using namespace std;
+
+// Time per instruction [ns]
+double ns_per_instruction(const Function& f, casadi_int n_instr, casadi_int n_eval) {
+  // Work vectors
+  vector<const double*> arg(f.sz_arg(), nullptr);
+  vector<double*> res(f.sz_res(), nullptr);
+  vector<casadi_int> iw(f.sz_iw());
+  vector<double> w(f.sz_w());
+
+  // Inputs and outputs
+  vector<double> x(f.nnz_in(0), 0.3), y(f.nnz_out(0));
+  arg[0] = get_ptr(x);
+  res[0] = get_ptr(y);
+
+  int mem = f.checkout();
+  auto t0 = chrono::high_resolution_clock::now();
+  for (casadi_int k=0; k<n_eval; ++k) f(get_ptr(arg), get_ptr(res), get_ptr(iw), get_ptr(w), mem);
+  auto t1 = chrono::high_resolution_clock::now();
+  f.release(mem);
+
+  return chrono::duration<double, nano>(t1-t0).count()/static_cast<double>(n_eval*n_instr);
+}
+
+int main(){
+  // Functions of increasing size
+  for (casadi_int n : {4, 16, 64, 256}) {
+    SX x = SX::sym("x", n);
+    SX z = 0;
+    for (casadi_int i=0; i<n; ++i) {
+      z = z + x(i)*x((i+1)%n) + 2*sin(x(i)) - x(i)/3;
+    }
+    Function f = Function("f", {x}, {z});
+    Function f_tc = Function("f", {x}, {z}, {{"threaded_code", true}});
+
+    casadi_int n_instr = f.n_instructions();
+    casadi_int n_eval = 10000000/n_instr;
+    cout << "n = " << n << ", " << n_instr << " instructions:" << endl;
+    cout << "  switch:        " << ns_per_instruction(f, n_instr, n_eval)
+         << " ns/instruction" << endl;
+    cout << "  threaded code: " << ns_per_instruction(f_tc, n_instr, n_eval)
+         << " ns/instruction" << endl;
+  }
+  return 0;
+}
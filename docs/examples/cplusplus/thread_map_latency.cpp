@@ -0,0 +1,90 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+/** \brief Latency of parallel maps of a small function
+ * NOTE: Example is mainly intended for developers of CasADi.
+ * Compares a "thread" map, which evaluates in the process-wide thread pool,
+ * with spawning and joining one std::thread per instance for each call.
+ */
+
+#include "casadi/casadi.hpp"
+#include <chrono>
+#include <thread>
+
+using namespace casadi;
+using namespace std;
+
+// Average time per call [us]
+template<typename F>
+double us_per_call(F fcn, casadi_int n_call) {
+  fcn();  // warm-up
+  auto t0 = chrono::high_resolution_clock::now();
+  for (casadi_int k=0; k<n_call; ++k) fcn();
+  auto t1 = chrono::high_resolution_clock::now();
+  return chrono::duration<double, micro>(t1-t0).count()/static_cast<double>(n_call);
+}
+
+int main(){
+  // Small function
+  SX x = SX::sym("x", 4);
+  Function f("f", {x}, {sin(x)*dot(x, x)});
+
+  for (casadi_int n : {4, 16, 64, 256, 1024}) {
+    vector<double> x_val(4*n, 0.3), r_val(4*n);
+
+    // Thread map, evaluated in the thread pool
+    Function fmap = f.map(n, "thread");
+    vector<const double*> arg(fmap.sz_arg());
+    vector<double*> res(fmap.sz_res());
+    vector<casadi_int> iw(fmap.sz_iw());
+    vector<double> w(fmap.sz_w());
+    arg[0] = get_ptr(x_val);
+    res[0] = get_ptr(r_val);
+    double t_pool = us_per_call([&]() {
+      fmap(get_ptr(arg), get_ptr(res), get_ptr(iw), get_ptr(w));
+    }, 100);
+
+    // Spawn and join one thread per instance
+    double t_spawn = us_per_call([&]() {
+      vector<thread> threads;
+      for (casadi_int i=0; i<n; ++i) {
+        threads.emplace_back([&, i]() {
+          vector<const double*> a(f.sz_arg());
+          vector<double*> r(f.sz_res());
+          vector<casadi_int> iw(f.sz_iw());
+          vector<double> w(f.sz_w());
+          a[0] = get_ptr(x_val) + 4*i;
+          r[0] = get_ptr(r_val) + 4*i;
+          f(get_ptr(a), get_ptr(r), get_ptr(iw), get_ptr(w));
+        });
+      }
+      for (auto&& th : threads) th.join();
+    }, 100);
+
+    cout << "n = " << n << ": pool " << t_pool << " us/call, spawn "
+         << t_spawn << " us/call" << endl;
+  }
+  return 0;
+}
@@ -55,3 +55,13 @@ t1 = time.time()
 print("evaluated parallel map function in %.3f seconds" % (t1 - t0))
 # the following has different shaped outputs, so it's commented out
 #print outNaive == outMap
+
+
+# evaluate it using the batched (SIMD) map construct, SX functions only
+fMap = f0.map(N, "simd")
+
+print("evaluating simd map function...")
+t0 = time.time()
+outMap = fMap(dummyInput)
+t1 = time.time()
+print("evaluated simd map function in %.3f seconds" % (t1 - t0))
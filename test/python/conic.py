@@ -1239,5 +1239,164 @@ class ConicTests(casadiTestCase):
       with self.assertInException("process"):
         solver(x0=0,lbg=0,ubg=0,lbx=[-10,-10],ubx=[10,10])
 
+  @requires_conic("qrqp")
+  def test_qrqp_warm_start(self):
+    H = DM([[1,-1],[-1,2]])
+    G = DM([-2,-6])
+    A =  DM([[1, 1],[-1, 2],[2, 1]])
+
+    opts = {"print_header":False,"print_iter":False}
+    cold = conic("cold","qrqp",{'h':H.sparsity(),'a':A.sparsity()},opts)
+    opts["warm_start"] = True
+    warm = conic("warm","qrqp",{'h':H.sparsity(),'a':A.sparsity()},opts)
+
+    for uba in [[2, 2, 3],[2, 2, 3],[2.1, 2, 3],[2.1, 1.9, 3],[1, 1, 1]]:
+      args = dict(h=H,g=G,a=A,lbx=0,ubx=inf,lba=-inf,uba=uba)
+      ref = cold(**args)
+      sol = warm(**args)
+      self.assertTrue(warm.stats()["success"])
+      for k in ["x","lam_x","lam_a","cost"]:
+        self.checkarray(sol[k],ref[k],digits=8)
+
+    # Repeated solve converges immediately
+    cold(**args)
+    warm(**args)
+    self.assertLess(warm.stats()["iter_count"],cold.stats()["iter_count"])
+    self.assertEqual(warm.stats()["iter_count"],1)
+
+    # Changed Hessian invalidates the factorization
+    sol = warm(h=H+DM.eye(2),g=G,a=A,lbx=0,ubx=inf,lba=-inf,uba=uba)
+    ref = cold(h=H+DM.eye(2),g=G,a=A,lbx=0,ubx=inf,lba=-inf,uba=uba)
+    self.checkarray(sol["x"],ref["x"],digits=8)
+
+    warm2 = Function.deserialize(warm.serialize())
+    self.checkarray(warm2(**args)["x"],cold(**args)["x"],digits=8)
+
+  def test_qrqp_max_update(self):
+    n = 8
+    H = 2*DM.eye(n)
+    for i in range(n-1):
+      H[i,i+1] = -1
+      H[i+1,i] = -1
+    G = DM([-3, 4, -5, 6, -7, 8, -9, 10])
+    A = vertcat(DM.ones(1,n), DM([[1,-1,1,-1,1,-1,1,-1]]))
+    args = dict(h=H,g=G,a=A,lbx=-1,ubx=1,lba=vertcat(-1,-2),uba=vertcat(1,2))
+
+    opts = {"print_header":False,"print_iter":False}
+    ref_solver = conic("ref","qrqp",{'h':H.sparsity(),'a':A.sparsity()},opts)
+    ref = ref_solver(**args)
+    self.assertTrue(ref_solver.stats()["success"])
+
+    for max_update in [1, 3, 10]:
+      opts["max_update"] = max_update
+      solver = conic("solver","qrqp",{'h':H.sparsity(),'a':A.sparsity()},opts)
+      sol = solver(**args)
+      self.assertTrue(solver.stats()["success"])
+      self.assertEqual(solver.stats()["iter_count"],ref_solver.stats()["iter_count"])
+      for k in ["x","lam_x","lam_a","cost"]:
+        self.checkarray(sol[k],ref[k],digits=8)
+      self.check_serialize(solver,args)
+      self.check_codegen(solver,args,std="c99")
+
+  @requires_conic("ocpqp")
+  def test_ocpqp(self):
+    # Double integrator, variables [x0 u0 x1 u1 ... xN], constraints [gap0 lincon0 ...]
+    N = 6
+    w = []; g = []
+    lbw = []; ubw = []; lbg = []; ubg = []
+    f = 0
+    xk = SX.sym("x0",2)
+    w.append(xk); lbw += [1, 0.5]; ubw += [1, 0.5]
+    for k in range(N):
+      uk = SX.sym("u%d" % k)
+      w.append(uk); lbw += [-1]; ubw += [1]
+      xn = SX.sym("x%d" % (k+1),2)
+      w.append(xn); lbw += [-inf, -1]; ubw += [inf, inf]
+      f += dot(xk,xk) + 0.1*uk**2 + 0.3*xk[0]*uk
+      g.append(2*xn - 2*vertcat(xk[0]+0.1*xk[1], xk[1]+0.1*uk) - 0.01)
+      lbg += [0, 0]; ubg += [0, 0]
+      g.append(xk[0]+uk); lbg += [-inf]; ubg += [0.8]
+      xk = xn
+    f += 3*dot(xk,xk) + xk[1]
+    g.append(xk[0]-xk[1]); lbg += [-1]; ubg += [1]
+    x = vertcat(*w)
+    g = vertcat(*g)
+    [H, G] = hessian(f,x)
+    [H, G, A, g0] = Function("qp",[x],[H,G,jacobian(g,x),g])(0)
+    args = dict(h=H,g=G,a=A,lbx=lbw,ubx=ubw,lba=DM(lbg)-g0,uba=DM(ubg)-g0)
+
+    ref_solver = conic("ref","qrqp",{'h':H.sparsity(),'a':A.sparsity()},{"print_header":False,"print_iter":False})
+    ref = ref_solver(**args)
+
+    # Detected structure, user-provided structure and a single dense stage,
+    # the latter treating the dynamics as general equality constraints
+    for struct, digits in [({"tol":1e-12}, 10),
+                           ({"tol":1e-12,"N":N,"nx":[2]*(N+1),"nu":[1]*N,"ng":[1]*(N+1)}, 10),
+                           ({"N":0,"nx":[3*N+2],"nu":[],"ng":[3*N+1]}, 5)]:
+      opts = {"print_header":False,"print_iter":False}
+      opts.update(struct)
+      solver = conic("solver","ocpqp",{'h':H.sparsity(),'a':A.sparsity()},opts)
+      sol = solver(**args)
+      self.assertTrue(solver.stats()["success"])
+      for k in ["x","lam_x","lam_a","cost"]:
+        self.checkarray(sol[k],ref[k],digits=digits)
+      self.check_serialize(solver,args)
+      self.check_codegen(solver,args,std="c99")
+
+    with self.assertInException("structure"):
+      conic("solver","ocpqp",{'h':H.sparsity(),'a':A.sparsity()},
+        {"N":N,"nx":[2]*(N+1),"nu":[1]*N,"ng":[0]*N+[N+1]})
+
+  @requires_conic("ipqp")
+  def test_ipqp(self):
+    # Fixed variables, equality constraints, one-sided and unbounded rows
+    N = 6
+    w = []; g = []
+    lbw = []; ubw = []; lbg = []; ubg = []
+    f = 0
+    xk = SX.sym("x0",2)
+    w.append(xk); lbw += [1, 0.5]; ubw += [1, 0.5]
+    for k in range(N):
+      uk = SX.sym("u%d" % k)
+      w.append(uk); lbw += [-1]; ubw += [1]
+      xn = SX.sym("x%d" % (k+1),2)
+      w.append(xn); lbw += [-inf, -1]; ubw += [inf, inf]
+      f += dot(xk,xk) + 0.1*uk**2 + 0.3*xk[0]*uk
+      g.append(2*xn - 2*vertcat(xk[0]+0.1*xk[1], xk[1]+0.1*uk) - 0.01)
+      lbg += [0, 0]; ubg += [0, 0]
+      g.append(xk[0]+uk); lbg += [-inf]; ubg += [0.8]
+      g.append(xk[1]-uk); lbg += [-inf]; ubg += [inf]
+      xk = xn
+    f += 3*dot(xk,xk) + xk[1]
+    g.append(xk[0]-xk[1]); lbg += [-1]; ubg += [1]
+    x = vertcat(*w)
+    g = vertcat(*g)
+    [H, G] = hessian(f,x)
+    [H, G, A, g0] = Function("qp",[x],[H,G,jacobian(g,x),g])(0)
+    args = dict(h=H,g=G,a=A,lbx=lbw,ubx=ubw,lba=DM(lbg)-g0,uba=DM(ubg)-g0)
+
+    ref_solver = conic("ref","qrqp",{'h':H.sparsity(),'a':A.sparsity()},{"print_header":False,"print_iter":False})
+    ref = ref_solver(**args)
+
+    solver = conic("solver","ipqp",{'h':H.sparsity(),'a':A.sparsity()},
+      {"print_header":False,"print_iter":False,"tol":1e-12})
+    sol = solver(**args)
+    self.assertTrue(solver.stats()["success"])
+    for k in ["x","lam_x","lam_a","cost"]:
+      self.checkarray(sol[k],ref[k],digits=10)
+    self.check_serialize(solver,args)
+    self.check_codegen(solver,args,std="c99")
+
+    # Linear program
+    x = SX.sym("x",3)
+    lp = {"x":x,"f":-x[0]-2*x[1]+0.5*x[2],"g":vertcat(x[0]+x[1]+x[2],x[0]-x[1])}
+    args = dict(lbx=[0,0,0],ubx=[inf,4,10],lbg=[-inf,-1],ubg=[5,1])
+    ref = qpsol("ref","qrqp",lp,{"print_header":False,"print_iter":False})(**args)
+    solver = qpsol("solver","ipqp",lp,{"print_header":False,"print_iter":False})
+    sol = solver(**args)
+    for k in ["x","lam_x","lam_g","f"]:
+      self.checkarray(sol[k],ref[k],digits=7)
+    self.check_codegen(solver,args,std="c99")
+
 if __name__ == '__main__':
     unittest.main()
@@ -581,7 +581,7 @@ class Functiontests(casadiTestCase):
     Z = [MX.sym("z",2,2) for i in range(n)]
     V = [MX.sym("z",Sparsity.upper(3)) for i in range(n)]
 
-    for parallelization in ["serial","openmp","unroll","inline","thread"]:
+    for parallelization in ["serial","openmp","unroll","inline","thread","simd"]:
         print(parallelization)
         res = fun.map(n, parallelization).call([horzcat(*x) for x in [X,Y,Z,V]])
 
@@ -627,6 +627,59 @@ class Functiontests(casadiTestCase):
     self.checkfunction_light(fun.map(4,"thread",2),fun.map(4),inputs=[hcat(X_[:4]),hcat(Y_[:4]),hcat(Z_[:4]),hcat(V_[:4])])
     self.checkfunction_light(fun.map(4,"thread",5),fun.map(4),inputs=[hcat(X_[:4]),hcat(Y_[:4]),hcat(Z_[:4]),hcat(V_[:4])])
 
+  def test_map_simd(self):
+    x = SX.sym("x")
+    y = SX.sym("y",2)
+    z = SX.sym("z",2,2)
+    v = SX.sym("z",Sparsity.upper(3))
+
+    fun = Function("f",[x,y,z,v],[mtimes(z,y)+x,sin(y*x).T,v/x,fmax(x,2*y)])
+
+    for n in [1,3,64,130]:
+      X_ = DM(repmat(x.sparsity(),1,n),np.random.random(n*x.nnz()))
+      Y_ = DM(repmat(y.sparsity(),1,n),np.random.random(n*y.nnz()))
+      Z_ = DM(repmat(z.sparsity(),1,n),np.random.random(n*z.nnz()))
+      V_ = DM(repmat(v.sparsity(),1,n),np.random.random(n*v.nnz()))
+
+      F = fun.map(n,"simd")
+      if n>1: self.assertTrue(F.is_a("SimdMap"))
+      self.checkfunction_light(F,fun.map(n),inputs=[X_,Y_,Z_,V_])
+
+    # Falls back to serial evaluation for non-SX functions
+    xm = MX.sym("x")
+    self.assertFalse(Function("g",[xm],[sin(xm)]).map(3,"simd").is_a("SimdMap"))
+
+  def test_map_thread_pool(self):
+    x = SX.sym("x",2)
+    fun = Function("f",[x],[sin(x)*sumsqr(x)])
+
+    # More instances than workers in the pool
+    for n in [2,7,100]:
+      X_ = DM.rand(2,n)
+      self.checkfunction_light(fun.map(n,"thread"),fun.map(n),inputs=[X_])
+
+    # Nested thread maps share the same pool
+    inner = fun.map(5,"thread")
+    xs = MX.sym("x",2,5)
+    g = Function("g",[xs],[inner(xs)])
+    X_ = DM.rand(2,5*20)
+    self.checkfunction_light(g.map(20,"thread"),g.map(20),inputs=[X_])
+
+  def test_checkout(self):
+    x = SX.sym("x")
+    f = Function("f",[x],[sin(x)])
+
+    # Memory objects in use are distinct
+    m = [f.checkout() for i in range(20)]
+    self.assertEqual(len(set(m)),20)
+    for i in m: f.release(i)
+
+    # Released memory objects are reused, indices remain valid
+    m2 = [f.checkout() for i in range(20)]
+    self.assertEqual(set(m2),set(m))
+    for i in m2: f.release(i)
+    self.checkarray(f(0.5),sin(0.5))
+
   @memory_heavy()
   def test_mapsum(self):
     x = SX.sym("x")
@@ -729,6 +782,36 @@ class Functiontests(casadiTestCase):
 
             self.check_serialize(F,inputs=inputs)
 
+  def test_map_openmp_codegen(self):
+    x = SX.sym("x")
+    y = SX.sym("y",2)
+    z = SX.sym("z",2,2)
+
+    fun = Function("f",[x,y,z],[mtimes(z,y)+x,sin(y*x).T])
+
+    n = 5
+    np.random.seed(0)
+    X_ = DM.rand(1,n)
+    Y_ = DM.rand(2,n)
+    Z_ = DM.rand(2,2)
+
+    # Plain map and map with reduced inputs and outputs
+    cases = [(fun.map(n,"openmp"), fun.map(n,"serial"), [X_,Y_,repmat(Z_,1,n)]),
+             (fun.map("map","openmp",n,[2],[0]), fun.map("map","serial",n,[2],[0]), [X_,Y_,Z_])]
+
+    for F, Fref, inputs in cases:
+      self.checkfunction(F,Fref,inputs=inputs)
+      self.check_serialize(F,inputs=inputs)
+      for schedule in ["static","dynamic","guided"]:
+        for chunk in [0,2]:
+          opts = {"openmp_schedule": schedule, "openmp_chunk": chunk}
+          self.check_codegen(F,inputs=inputs,opts=opts)
+          if os.name!='nt':
+            self.check_codegen(F,inputs=inputs,opts=opts,extra_options=["-fopenmp"])
+
+    with self.assertInException("openmp_schedule"):
+      CodeGenerator("f_omp.c", {"openmp_schedule": "auto"})
+
   def test_repmatnode(self):
     x = MX.sym("x",2)
 
@@ -1946,6 +2029,84 @@ class Functiontests(casadiTestCase):
     self.check_codegen(f,inputs=[np.random.random((3,3))])
     self.check_codegen(f,inputs=[np.random.random((3,3))], opts={"avoid_stack": True})
 
+  def test_codegen_simd(self):
+    x = SX.sym("x",2)
+    y = SX.sym("y")
+    f = Function('f',[x,y],[sin(x)*y+x[0]**2, y])
+    self.check_codegen(f,inputs=[DM([0.3,0.7]),1.2], opts={"simd": True})
+    self.check_codegen(f,inputs=[DM([0.3,0.7]),1.2], opts={"simd": True, "avoid_stack": True})
+
+    if args.run_slow and os.name!='nt':
+      import ctypes
+      import subprocess
+      f.generate("f_codegen_simd.c", {"simd": True})
+      subprocess.check_call("gcc -fPIC -shared -O3 f_codegen_simd.c -o f_codegen_simd.so -lm",shell=True)
+      lib = ctypes.CDLL("./f_codegen_simd.so")
+
+      # n instances, structure of arrays layout
+      n = 7
+      X = np.random.random((n,2))
+      Y = np.random.random((n,1))
+      R0 = np.zeros((2,n))
+      R1 = np.zeros((1,n))
+      X_soa = np.ascontiguousarray(X.T)
+      Y_soa = np.ascontiguousarray(Y.T)
+      dp = ctypes.POINTER(ctypes.c_double)
+      arg = (dp*2)(X_soa.ctypes.data_as(dp), Y_soa.ctypes.data_as(dp))
+      res = (dp*2)(R0.ctypes.data_as(dp), R1.ctypes.data_as(dp))
+      lib.f_simd.argtypes = [ctypes.c_void_p, ctypes.c_void_p, ctypes.c_longlong,
+                             ctypes.c_void_p, ctypes.c_void_p, ctypes.c_int]
+      self.assertEqual(lib.f_simd(arg, res, n, None, None, 0), 0)
+      for k in range(n):
+        [r0,r1] = f(X[k,:],Y[k,0])
+        self.checkarray(R0[:,k],r0)
+        self.checkarray(R1[:,k],r1)
+
+
+  def test_codegen_chunks(self):
+    x = SX.sym("x",3)
+    y = SX.sym("y")
+    e = x*y
+    for i in range(10):
+      e = sin(e)+y*e
+    f = Function('f',[x,y],[e, dot(e,x)])
+
+    import shutil
+    import tempfile
+    tmp_dir = tempfile.mkdtemp()
+    prefix = os.path.join(tmp_dir, "")
+    try:
+      # Fewer instructions than the chunk size: no extra files
+      g = CodeGenerator("f_nochunk.c", {"chunk_size": 10000})
+      g.add(f)
+      g.generate(prefix)
+      self.assertFalse(os.path.exists(prefix + "f_nochunk_chunk0.c"))
+
+      g = CodeGenerator("f_chunked.c", {"chunk_size": 7})
+      g.add(f)
+      g.generate(prefix)
+      self.assertTrue(os.path.exists(prefix + "f_chunked_chunk0.c"))
+      self.assertTrue(os.path.exists(prefix + "f_chunked_chunk1.c"))
+
+      # Returned as a string, the chunks are included
+      code = g.dump()
+      self.assertTrue("casadi_chunk1(const casadi_real** arg, casadi_real** res, casadi_real* w) {" in code)
+
+      if os.name!='nt':
+        import subprocess
+        import glob
+        sources = sorted(glob.glob(prefix + "f_chunked_chunk*.c"))
+        subprocess.check_call("gcc -fPIC -shared -O2 " + prefix + "f_chunked.c " + " ".join(sources) + " -o " + prefix + "f_chunked.so -lm",shell=True)
+        F = external("f", prefix + "f_chunked.so")
+        inputs = [DM([0.3,0.7,1.1]),0.4]
+        self.checkfunction_light(f, F, inputs=inputs)
+
+        # Chunked jit, compiled in parallel
+        if args.run_slow:
+          F = Function('f',[x,y],[e, dot(e,x)], {"jit": True, "compiler": "shell", "jit_chunk_size": 7})
+          self.checkfunction_light(f, F, inputs=inputs)
+    finally:
+      shutil.rmtree(tmp_dir)
 
   def test_serialize(self):
     for opts in [{"debug":True},{}]:
@@ -2020,6 +2181,30 @@ class Functiontests(casadiTestCase):
       fs = Function.deserialize(f.serialize(opts))
       self.checkfunction(f,fs,inputs=[1.1, vertcat(2.7,3)],hessian=False)
 
+  def test_save_binary(self):
+    x = MX.sym("x")
+    y = MX.sym("y",2)
+    xs = SX.sym("x",2)
+    g = Function("g",[xs],[sin(xs)*xs[0]+DM([1.5,2.5])])
+    q = g(y)*x + mtimes(DM([[1,3],[7,8]]),y)
+    f = Function("f",[x,y],[q,jacobian(q, vertcat(x, y))],["x","y"],["q","J"])
+
+    for opts in [{"binary":True},{"binary":True,"debug":True},{}]:
+      f.save("f_binary.casadi",opts)
+      for load_opts in [{},{"mmap":True}]:
+        fs = Function.load("f_binary.casadi",load_opts)
+        self.assertEqual(fs.name_in(1), "y")
+        self.checkfunction(f,fs,inputs=[1.1, vertcat(2.7,3)],hessian=False)
+
+    # Binary files are much more compact than the text format
+    f.save("f_binary.casadi",{"binary":True})
+    n_binary = os.path.getsize("f_binary.casadi")
+    f.save("f_binary.casadi")
+    self.assertTrue(n_binary<os.path.getsize("f_binary.casadi"))
+
+    with self.assertInException("Unknown option"):
+      Function.load("f_binary.casadi",{"foo":True})
+
   @memory_heavy()
   def test_serialize_recursion_limit(self):
       for X in [SX,MX]:
@@ -2062,6 +2247,25 @@ class Functiontests(casadiTestCase):
 
     self.checkfunction(F,Fref,inputs=[DM([[1,2],[3,7]])])
 
+  def test_fold_checkpoints(self):
+    x = MX.sym("x",2)
+    u = MX.sym("u")
+    f = Function("f",[x,u],[x+0.01*vertcat(x[1],-sin(x[0])+u),x[0]*u])
+    N = 1000
+    F = f.fold(N)
+    X = MX.sym("x",2)
+    U = MX.sym("u",1,N)
+    for checkpoints in [10, 50, 200]:
+      Fc = f.fold(N,{"checkpoints": checkpoints})
+      inputs = [DM([0.3,0.1]),DM.rand(1,N)]
+      self.checkfunction_light(F,Fc,inputs=inputs)
+      # Gradient through reverse mode
+      J = Function("J",[X,U],[gradient(sum1(F(X,U)[0]),vertcat(X,U.T))])
+      Jc = Function("J",[X,U],[gradient(sum1(Fc(X,U)[0]),vertcat(X,U.T))])
+      self.checkfunction_light(J,Jc,inputs=inputs)
+      # Fewer states stored in reverse mode
+      self.assertTrue(Jc.sz_w()<J.sz_w())
+
 
   @memory_heavy()
   def test_thread_safety(self):
@@ -2126,6 +2330,51 @@ class Functiontests(casadiTestCase):
         self.assertTrue("[[-1e-07]," in out[0] or "[[-1e-007]," in out[0] )
         self.assertTrue("[[1e-07]," in out[0] or "[[1e-007]," in out[0] )
 
+  @requiresPlugin(Importer,"shell")
+  def test_jit_cache(self):
+    if os.name=='nt': return
+    import shutil
+    import tempfile
+    cache_dir = tempfile.mkdtemp()
+    try:
+      x = SX.sym("x",2)
+      opts = {"jit":True,"compiler":"shell","jit_options":{"cache_dir":cache_dir}}
+
+      f = Function('f',[x],[sin(x)*x[0]],opts)
+      f([0.3,0.4])
+      self.assertFalse(f.stats()["jit_cache_hit"])
+      self.assertEqual(len(os.listdir(cache_dir)),1)
+
+      # Identical function: loaded from the cache
+      g = Function('f',[x],[sin(x)*x[0]],opts)
+      g([0.3,0.4])
+      self.assertTrue(g.stats()["jit_cache_hit"])
+      self.assertEqual(g.stats()["jit_cache_hits"]-f.stats()["jit_cache_hits"],1)
+      self.checkfunction_light(f, g, inputs=[DM([0.3,0.4])])
+
+      # Different flags: miss
+      opts2 = {"jit":True,"compiler":"shell","jit_options":{"cache_dir":cache_dir,"flags":["-O1"]}}
+      h = Function('f',[x],[sin(x)*x[0]],opts2)
+      self.assertFalse(h.stats()["jit_cache_hit"])
+      self.assertEqual(len(os.listdir(cache_dir)),2)
+
+      # Size bound, least recently used evicted, the new entry kept
+      opts3 = {"jit":True,"compiler":"shell","jit_options":{"cache_dir":cache_dir,"cache_size":1}}
+      Function('f',[x],[cos(x)],opts3)
+      self.assertEqual(len(os.listdir(cache_dir)),1)
+      k = Function('f',[x],[cos(x)],opts3)
+      self.assertTrue(k.stats()["jit_cache_hit"])
+
+      # Missing directories are created, statistics are kept per directory
+      sub_dir = os.path.join(cache_dir,"a","b")
+      opts4 = {"jit":True,"compiler":"shell","jit_options":{"cache_dir":sub_dir}}
+      l = Function('f',[x],[sin(x)*x[0]],opts4)
+      self.assertFalse(l.stats()["jit_cache_hit"])
+      self.assertEqual(l.stats()["jit_cache_hits"],0)
+      self.assertEqual(len(os.listdir(sub_dir)),1)
+    finally:
+      shutil.rmtree(cache_dir)
+
   @requires_nlpsol("ipopt")
   @requiresPlugin(Importer,"shell")
   def test_inherit_jit_options(self):
@@ -2724,6 +2973,40 @@ class Functiontests(casadiTestCase):
     f2 = ff.get_function("f")
 
     self.checkfunction_light(g, f2, inputs=[3])
+
+  def test_threaded_code(self):
+    x = SX.sym("x",3)
+    y = SX.sym("y",2)
+    z = x[0]*y[0]+x[1]*x[2] + 3*x[1] - 2/x[2] + sin(x[0]*y[1]+7)*exp(x[2])
+    z = vertcat(z, atan2(x[0],y[1])*x[1]+y[0], (x[2]-4)*sqrt(y[1]*y[1]+1), fmin(x[0],2))
+    inputs = [DM([0.3,1.7,-2.1]),DM([0.9,4.5])]
+    for live_variables in [True, False]:
+      f = Function("f",[x,y],[z],{"live_variables":live_variables})
+      fc = Function("f",[x,y],[z],{"live_variables":live_variables,"threaded_code":True})
+      # Bit-identical results
+      self.assertTrue(np.all(np.array(f(*inputs))==np.array(fc(*inputs))))
+      self.checkfunction_light(fc, f, inputs=inputs)
+      fs = Function.deserialize(fc.serialize())
+      self.assertTrue(np.all(np.array(f(*inputs))==np.array(fs(*inputs))))
+
+  def test_jit_native(self):
+    import platform
+    if platform.machine().lower() not in ["x86_64","amd64"] or sys.platform.startswith("win"): return
+    x = SX.sym("x",3)
+    y = SX.sym("y",2)
+    z = vertcat(x[0]*y[0]+x[1]/x[2]-3, sin(x[0])*exp(y[1]), -sqrt(x[1])+x[2]**2, atan2(x[0],y[0]), 2*x[1], fmax(x[0],y[1]))
+    inputs = [DM([0.3,1.7,-2.1]),DM([0.9,4.5])]
+    f = Function("f",[x,y],[z, x[0]])
+    fj = Function("f",[x,y],[z, x[0]],{"jit":True,"compiler":"native"})
+    self.checkfunction_light(fj, f, inputs=inputs)
+    # Null arguments and results
+    self.checkarray(fj(DM([0.3,1.7,-2.1]),0)[1],DM(0.3))
+    fs = Function.deserialize(fj.serialize())
+    self.checkfunction_light(fs, f, inputs=inputs)
+
+    with self.assertInException("not supported"):
+      xm = MX.sym("x")
+      Function("f",[xm],[sin(xm)],{"jit":True,"compiler":"native"})
           
 if __name__ == '__main__':
     unittest.main()
@@ -502,6 +502,28 @@ class LinearSolverTests(casadiTestCase):
     self.check_codegen(f, inputs=[As[0]])
     self.check_serialize(f, inputs=[As[0]])
 
+  def test_qr_single_precision(self):
+    n = 8
+    np.random.seed(0)
+    A0 = DM(np.random.random((n,n))+n*np.eye(n))
+    b = DM(np.random.random((n,2)))
+    for tr in [False, True]:
+      ref = np.linalg.solve(A0.T if tr else A0,b)
+      # Single precision only
+      solver = Linsol("solver", "qr", A0.sparsity(), {"precision": "single"})
+      x = solver.solve(A0, b, tr)
+      self.checkarray(x, ref, digits=4)
+      self.assertTrue(np.max(np.abs(x-ref))>1e-12)
+      # Refined to double precision accuracy
+      solver = Linsol("solver", "qr", A0.sparsity(), {"precision": "single", "max_refine": 10})
+      x = solver.solve(A0, b, tr)
+      self.checkarray(x, ref, digits=12)
+
+    A = MX.sym("A",n,n)
+    f = Function('f',[A],[solve(A, DM.ones(n), "qr", {"precision": "single", "max_refine": 10})])
+    self.checkarray(f(A0), np.linalg.solve(A0,np.ones(n)), digits=12)
+    self.check_serialize(f, inputs=[A0])
+
   @memory_heavy()
   def test_thread_safety(self):
     x = MX.sym('x')
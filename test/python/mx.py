@@ -2939,6 +2939,87 @@ class MXtests(casadiTestCase):
 
         self.check_codegen(f,inputs=[A])
 
+  def test_mtimes_batched_ad(self):
+    x = MX.sym("x",3,4)
+    y = MX.sym("y",Sparsity.lower(4))
+    f = Function("f",[x,y],[mtimes(x,y)])
+    x0 = DM.rand(3,4)
+    y0 = DM.rand(4,4)
+    def n_mtimes(F):
+      return len([k for k in range(F.n_instructions()) if F.instruction_id(k)==OP_MTIMES])
+    for K in [1,2,5]:
+      seeds_x = [DM.rand(3,4) for k in range(K)]
+      seeds_y = [DM.rand(4,4) for k in range(K)]
+      seeds_z = [DM.rand(3,4) for k in range(K)]
+      # Forward, all directions at once
+      ff = f.forward(K)
+      # Two products for all directions, rather than two per direction
+      self.assertEqual(n_mtimes(ff),2)
+      fwd = ff(x0,y0,f(x0,y0),hcat(seeds_x),hcat(seeds_y))
+      for k in range(K):
+        ref = mtimes(seeds_x[k],y0)+mtimes(x0,project(seeds_y[k],y.sparsity()))
+        self.checkarray(fwd[:,4*k:4*(k+1)],ref,digits=10)
+      # Reverse, all directions at once
+      fr = f.reverse(K)
+      self.assertEqual(n_mtimes(fr),2)
+      adj = fr(x0,y0,f(x0,y0),hcat(seeds_z))
+      for k in range(K):
+        self.checkarray(adj[0][:,4*k:4*(k+1)],mtimes(seeds_z[k],y0.T),digits=10)
+        self.checkarray(adj[1][:,4*k:4*(k+1)],project(mtimes(x0.T,seeds_z[k]),y.sparsity()),digits=10)
+      self.check_codegen(fr,inputs=[x0,y0,f(x0,y0),hcat(seeds_z)])
+
+  def test_mtimes_kernels(self):
+    # Dense*dense (with remainder columns), sparse*dense and sparse*sparse
+    for sp_x, sp_y in [(Sparsity.dense(5,7),Sparsity.dense(7,3)),
+                       (Sparsity.dense(4,8),Sparsity.dense(8,1)),
+                       (Sparsity.banded(6,1),Sparsity.dense(6,4)),
+                       (Sparsity.lower(6),Sparsity.dense(6,2)),
+                       (Sparsity.banded(6,1),Sparsity.lower(6))]:
+      x = MX.sym("x",sp_x)
+      y = MX.sym("y",sp_y)
+      z = MX.sym("z",sp_x.size1(),sp_y.size2())
+      f = Function("f",[x,y,z],[mtimes(x,y)+z,mtimes(x,y)])
+      x0 = DM(sp_x,DM.rand(sp_x.nnz()))
+      y0 = DM(sp_y,DM.rand(sp_y.nnz()))
+      z0 = DM.rand(sp_x.size1(),sp_y.size2())
+      [r0,r1] = f(x0,y0,z0)
+      self.checkarray(r0,mtimes(x0,y0)+z0,digits=12)
+      self.checkarray(r1,mtimes(x0,y0),digits=12)
+      fs = f.expand()
+      self.checkfunction_light(f,fs,inputs=[x0,y0,z0])
+      self.check_codegen(f,inputs=[x0,y0,z0])
+
+  def test_codegen_unroll(self):
+    x = MX.sym("x",Sparsity.banded(4,1))
+    y = MX.sym("y",Sparsity.lower(4))
+    v = MX.sym("v",4)
+    e = [mtimes(x,y), mtimes(x,v), x.T, project(y,Sparsity.upper(4)), mtimes(y,v)+v]
+    f = Function("f",[x,y,v],e)
+    inputs = [DM(x.sparsity(),DM.rand(x.nnz())),DM(y.sparsity(),DM.rand(y.nnz())),DM.rand(4)]
+    # Unrolled, partially unrolled, not unrolled
+    for unroll in [1000, 10, 0]:
+      self.check_codegen(f,inputs=inputs,opts={"unroll": unroll})
+    g = CodeGenerator("f_unroll.c", {"unroll": 1000})
+    g.add(f)
+    code = g.dump()
+    self.assertFalse("casadi_mtimes(" in code)
+    self.assertFalse("casadi_trans(" in code)
+
+  def test_cse(self):
+    x = MX.sym("x",3)
+    A = MX.sym("A",3,3)
+    g = Function("g",[x],[sin(x),x**2])
+    # Structurally identical, but distinct nodes
+    e1 = mtimes(A,sin(x))+g(x)[1]
+    e2 = mtimes(A,sin(x))+g(x)[1]
+    [r1,r2] = cse([e1,e2])
+    self.assertTrue(is_equal(r1,r2))
+
+    f = Function("f",[x,A],[e1,e2])
+    fc = Function("f",[x,A],[e1,e2],{"cse":True})
+    self.assertTrue(fc.n_instructions()<f.n_instructions())
+    self.checkfunction_light(f,fc,inputs=[DM([1,2,3]),DM.rand(3,3)])
+
     
 if __name__ == '__main__':
     unittest.main()
@@ -1506,6 +1506,44 @@ class NLPtests(casadiTestCase):
     self.assertTrue(stats_reg["iter_count"]==1)
     self.assertTrue("H:\n[[1, 0], \n [0, 2]]" in result[0])
 
+  @requires_conic("qrqp")
+  def test_lbfgs_sqpmethod(self):
+    # Multiple shooting Van der Pol, variables [x0 u0 x1 u1 ... xN]
+    N = 10
+    w = []; g = []
+    lbw = []; ubw = []
+    f = 0
+    xk = SX.sym("x0",2)
+    w.append(xk); lbw += [0, 1]; ubw += [0, 1]
+    for k in range(N):
+      uk = SX.sym("u%d" % k)
+      w.append(uk); lbw += [-1]; ubw += [1]
+      xn = xk + 0.2*vertcat((1-xk[1]**2)*xk[0]-xk[1]+uk, xk[0])
+      f += 0.2*(sumsqr(xk)+uk**2)
+      xk = SX.sym("x%d" % (k+1),2)
+      w.append(xk); lbw += [-0.25, -inf]; ubw += [inf, inf]
+      g.append(xn-xk)
+    nlp = {"x":vertcat(*w),"f":f+sumsqr(xk),"g":vertcat(*g)}
+    args = dict(lbx=lbw,ubx=ubw,lbg=0,ubg=0)
+
+    opts = {"qpsol":"qrqp","qpsol_options": {"print_iter":False,"print_header":False},
+            "print_header":False,"print_iteration":False,"print_time":False}
+    ref = nlpsol("solver","sqpmethod",nlp,opts)(**args)
+
+    opts["hessian_approximation"] = "limited-memory"
+    opts["tol_du"] = 1e-10
+    for extra in [{}, {"lbfgs_memory":3}, {"lbfgs_blocks":[3*N+2]}, {"lbfgs_blocks":[3]*N+[2]}]:
+      opts.update(extra)
+      solver = nlpsol("solver","sqpmethod",nlp,opts)
+      res = solver(**args)
+      self.assertTrue(solver.stats()["success"])
+      self.checkarray(res["x"],ref["x"],digits=7)
+      self.checkarray(res["f"],ref["f"],digits=7)
+
+    opts["lbfgs_blocks"] = [3]*N
+    with self.assertInException("lbfgs_blocks"):
+      nlpsol("solver","sqpmethod",nlp,opts)
+
   def test_indefinite(self):
 
     # Test problem that is indefinite in direction of the constraint Jacobian
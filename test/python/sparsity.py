@@ -490,6 +490,93 @@ class Sparsitytests(casadiTestCase):
     sp2 = hessian(H,x)[0].sparsity()
     self.assertTrue(sp==sp2)
 
+  def test_jacsparsity_parallel(self):
+    hier = GlobalOptions.getHierarchicalSparsity()
+    GlobalOptions.setHierarchicalSparsity(False)
+    x = SX.sym("x",1000)
+    xm = MX.sym("x",1000)
+    # Forward sweeps (more outputs than inputs) and reverse sweeps (fewer outputs)
+    for e in [vertcat(x*x[::-1],sin(x),sum1(x[::7])), vertcat(x[1:300]*x[:299],sin(x[500]))]:
+      makers = [lambda: Function("f",[x],[e]),
+                lambda: Function("f",[xm],[Function("g",[x],[e])(xm)])]
+      for make in makers:
+        GlobalOptions.setParallelSparsity(False)
+        sp_ref = make().sparsity_jac(0,0)
+        GlobalOptions.setParallelSparsity(True)
+        sp = make().sparsity_jac(0,0)
+        self.assertTrue(sp==sp_ref)
+    GlobalOptions.setParallelSparsity(False)
+    GlobalOptions.setHierarchicalSparsity(hier)
+
+  def test_sparsity_cache(self):
+    import tempfile, os, shutil
+    d = tempfile.mkdtemp()
+    try:
+      GlobalOptions.setSparsityCacheDir(d)
+      x = SX.sym("x",1000)
+      e = vertcat(x[1:]*x[:-1],sin(x[::3]))
+      sp_ref = Function("f",[x],[e]).sparsity_jac(0,0)
+      self.assertTrue(len(os.listdir(d))>0)
+      # Warm start, read from the cache
+      n = len(os.listdir(d))
+      sp = Function("f",[x],[e]).sparsity_jac(0,0)
+      self.assertTrue(sp==sp_ref)
+      self.assertEqual(len(os.listdir(d)),n)
+      # Colorings
+      H = Sparsity.banded(2000,2)
+      GlobalOptions.setSparsityCacheDir("")
+      c_ref = [sp.uni_coloring(),H.star_coloring(),H.star_coloring2()]
+      GlobalOptions.setSparsityCacheDir(d)
+      for i in range(2):
+        c = [sp.uni_coloring(),H.star_coloring(),H.star_coloring2()]
+        for a,b in zip(c,c_ref): self.assertTrue(a==b)
+      # Corrupt entries are recomputed
+      for f in os.listdir(d):
+        with open(os.path.join(d,f),"w") as out: out.write("garbage")
+      sp = Function("f",[x],[e]).sparsity_jac(0,0)
+      self.assertTrue(sp==sp_ref)
+    finally:
+      GlobalOptions.setSparsityCacheDir("")
+      shutil.rmtree(d)
+
+  def test_jp_coloring(self):
+    def check_d2(sp,D):
+      # Columns of the same color do not share rows
+      A = DM(sp,1)
+      for c in range(D.size2()):
+        cols = D.row()[D.colind()[c]:D.colind()[c+1]]
+        self.assertTrue(float(mmax(sum2(A[:,cols])))<=1)
+    numpy.random.seed(0)
+    for sp in [Sparsity.banded(300,3), self.randDM(200,150,0.03).sparsity(), Sparsity.dense(5,7)]:
+      D = sp.jp_coloring()
+      self.assertEqual(D.size1(),sp.size2())
+      self.assertEqual(D.nnz(),sp.size2())
+      check_d2(sp,D)
+      # Deterministic
+      self.assertTrue(D==sp.jp_coloring())
+      # Recoloring never increases the number of colors
+      for n_pass in [1,4]:
+        D2 = sp.recolor(D,n_pass)
+        check_d2(sp,D2)
+        self.assertTrue(D2.size2()<=D.size2())
+      # Cutoff
+      if D.size2()>1: self.assertTrue(sp.jp_coloring(Sparsity(),D.size2()-1).is_null())
+
+    # Jacobian and Hessian with the Jones-Plassmann coloring
+    x = SX.sym("x",100)
+    f = sum1(x[1:]*sin(x[:-1]))+x[0]**3
+    g = vertcat(x[1:]-x[:-1]**2,x[0]*x[-1])
+    for opts in [{"coloring":"jones_plassmann"},{"coloring":"jones_plassmann","coloring_recolor":3},
+                 {"coloring_recolor":3}]:
+      F = Function("F",[x],[jacobian(g,x),hessian(f,x)[0]])
+      G = Function("G",[x],[g,f],opts)
+      xm = MX.sym("x",100)
+      G = Function("G",[xm],[jacobian(G(xm)[0],xm),hessian(G(xm)[1],xm)[0]])
+      x0 = DM.rand(100)
+      for a,b in zip(F(x0),G(x0)): self.checkarray(a,b)
+    with self.assertInException("Unknown coloring"):
+      Function("G",[x],[g],{"coloring":"foo"})
+
 
   def test_rowcol(self):
     n = 3
@@ -1438,6 +1438,41 @@ class SXtests(casadiTestCase):
   def test_ufunc(self):
     y = np.sin(casadi.SX.sym('x'))
 
+  def test_cse(self):
+    x = SX.sym("x")
+    y = SX.sym("y")
+    # Structurally identical, but distinct nodes
+    e = vertcat(sin(x)*y, sin(x)*y, cos(x+y)+3, 3+cos(y+x))
+    [r] = cse([e])
+    self.assertTrue(n_nodes(r)<n_nodes(e))
+    self.assertTrue(is_equal(r[0],r[1]))
+    self.assertTrue(is_equal(r[2],r[3]))
+    f = Function("f",[x,y],[e])
+    fr = Function("f",[x,y],[cse(e)])
+    self.checkfunction_light(f,fr,inputs=[0.3,0.7])
+
+    # Exposed as a Function option
+    fc = Function("f",[x,y],[e],{"cse":True})
+    self.assertTrue(fc.n_instructions()<f.n_instructions())
+    self.checkfunction_light(f,fc,inputs=[0.3,0.7])
+
+  def test_schedule(self):
+    x = SX.sym("x",5)
+    p = SX.sym("p")
+    # Shared subexpressions, wide and deep parts, constants and outputs of inputs
+    e = [x[0]*x[1]]
+    for i in range(30):
+      e.append(sin(e[-1]+x[i%5])*p + 2.5*e[i//2])
+    f = Function("f",[x,p],[vcat(e[::-1]),x[2],3*p**2],{"schedule":"depth_first"})
+    fs = Function("f",[x,p],[vcat(e[::-1]),x[2],3*p**2],{"schedule":"min_live"})
+    self.assertEqual(fs.n_instructions(),f.n_instructions())
+    inputs = [DM([0.1,0.2,0.3,0.4,0.5]),0.7]
+    self.checkfunction(f,fs,inputs=inputs)
+    self.check_codegen(fs,inputs=inputs)
+    self.check_serialize(fs,inputs=inputs)
+    with self.assertInException("schedule"):
+      Function("f",[x,p],[e[-1]],{"schedule":"foo"})
+
 
 
 if __name__ == '__main__':